@@ -8,16 +8,10 @@ PAGE 0 :  /* Program Memory */
    BEGIN           	: origin = 0x080000, length = 0x000002
    RAMM0           	: origin = 0x000123, length = 0x0002DD
    RAMD0           	: origin = 0x00B000, length = 0x000800
-   RAMLS0          	: origin = 0x008000, length = 0x000800
-   RAMLS1          	: origin = 0x008800, length = 0x000800
-   RAMLS2      		: origin = 0x009000, length = 0x000800
+   /* LS0-LS2 merged for the .TI.ramfunc hot path (ISRs, polling, statistics) */
+   RAMLS0_2        	: origin = 0x008000, length = 0x001800
    RAMLS3      		: origin = 0x009800, length = 0x000800
    RAMLS4      		: origin = 0x00A000, length = 0x000800
-   RAMGS14          : origin = 0x01A000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
-   RAMGS15          : origin = 0x01B000, length = 0x000FF8     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
-
-//   RAMGS15_RSVD     : origin = 0x01BFF8, length = 0x000008    /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
-
    RESET           	: origin = 0x3FFFC0, length = 0x000002
 
    /* Flash sectors */
@@ -54,19 +48,16 @@ PAGE 1 : /* Data Memory */
    RAMGS3      : origin = 0x00F000, length = 0x001000
    RAMGS4      : origin = 0x010000, length = 0x001000
    RAMGS5      : origin = 0x011000, length = 0x001000
-   RAMGS6      : origin = 0x012000, length = 0x001000
-   RAMGS7      : origin = 0x013000, length = 0x001000
-   RAMGS8      : origin = 0x014000, length = 0x001000
-   RAMGS9      : origin = 0x015000, length = 0x001000
-   RAMGS10     : origin = 0x016000, length = 0x001000
-
-//   RAMGS11     : origin = 0x017000, length = 0x000FF8   /* Uncomment for F28374D, F28376D devices */
-
-//   RAMGS11_RSVD : origin = 0x017FF8, length = 0x000008    /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
+   /* GS6..GS11 merged - one contiguous block for the scope capture buffer.
+      Only valid on F28379D, F28377D, F28375D (GS11 is 0xFF8 words elsewhere). */
+   RAMGS6_11   : origin = 0x012000, length = 0x006000
 
-   RAMGS11     : origin = 0x017000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
    RAMGS12     : origin = 0x018000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
    RAMGS13     : origin = 0x019000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
+   RAMGS14     : origin = 0x01A000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
+   RAMGS15     : origin = 0x01B000, length = 0x000FF8     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
+
+//   RAMGS15_RSVD     : origin = 0x01BFF8, length = 0x000008    /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
 
    CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
    CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
@@ -85,7 +76,7 @@ SECTIONS
 
 #if defined(__TI_EABI__)
    .init_array         : > FLASHB,       PAGE = 0,       ALIGN(8)
-   .bss                : >> RAMLS5 | RAMGS0 |RAMGS1 | RAMGS2 | RAMGS3 |RAMGS4 | RAMGS5 | RAMGS6 |RAMGS7 | RAMGS8 | RAMGS9 |RAMGS10 | RAMGS11 | RAMGS12 |RAMGS13,       PAGE = 1
+   .bss                : >> RAMLS5 | RAMGS0 |RAMGS1 | RAMGS2 | RAMGS3 |RAMGS4 | RAMGS5 | RAMGS12 |RAMGS13 | RAMD1,       PAGE = 1
    .bss:output         : > RAMLS3,       PAGE = 0
    .bss:cio            : > RAMLS5,       PAGE = 1
    .data               : > RAMLS5,       PAGE = 1
@@ -109,11 +100,17 @@ SECTIONS
    ramgs0           : > RAMGS0,     PAGE = 1
    ramgs1           : > RAMGS1,     PAGE = 1
 
+   /* Sweep results + checkpoint - not zeroed at startup so a reset can resume */
+   sweepckpt        : >> RAMGS14 | RAMGS15,  PAGE = 1, TYPE = NOINIT
+
+   /* Scope capture circular DMA buffer - NOINIT, filled before every dump */
+   scopebuf         : > RAMGS6_11,  PAGE = 1, TYPE = NOINIT
+
 #ifdef __TI_COMPILER_VERSION__
     #if __TI_COMPILER_VERSION__ >= 15009000
         #if defined(__TI_EABI__)
             .TI.ramfunc : {} LOAD = FLASHD,
-                                 RUN = RAMLS0,
+                                 RUN = RAMLS0_2,
                                  LOAD_START(RamfuncsLoadStart),
                                  LOAD_SIZE(RamfuncsLoadSize),
                                  LOAD_END(RamfuncsLoadEnd),
@@ -123,7 +120,7 @@ SECTIONS
                                  PAGE = 0, ALIGN(8)
         #else
             .TI.ramfunc : {} LOAD = FLASHD,
-                             RUN = RAMLS0,
+                             RUN = RAMLS0_2,
                              LOAD_START(_RamfuncsLoadStart),
                              LOAD_SIZE(_RamfuncsLoadSize),
                              LOAD_END(_RamfuncsLoadEnd),
@@ -134,7 +131,7 @@ SECTIONS
         #endif
     #else
    ramfuncs            : LOAD = FLASHD,
-                         RUN = RAMLS0,
+                         RUN = RAMLS0_2,
                          LOAD_START(_RamfuncsLoadStart),
                          LOAD_SIZE(_RamfuncsLoadSize),
                          LOAD_END(_RamfuncsLoadEnd),
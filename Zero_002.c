@@ -3,67 +3,517 @@
  *******************************************************************************/
 #include "Zero_002.h"
 
-/* LEVEL 1: Shared runtime arrays - REUSED during sampling */
-volatile uint16_t adcResults[MAX_CHANNELS][RESULTS_BUFFER_SIZE];
+/* LEVEL 1: Shared runtime arrays - REUSED during sampling. The sample
+ * buffers point into samplePool, sized by sweepCfg.samples at run start */
+static volatile uint16_t samplePool[SAMPLE_POOL_WORDS];
+volatile uint16_t* adcResults[MAX_CHANNELS];
 volatile uint16_t adcIndex[MAX_CHANNELS];
 volatile uint16_t adcSampleCount[MAX_CHANNELS];
 volatile uint16_t adcComplete[MAX_CHANNELS];
 
-/* LEVEL 2: Persistent storage - KEEPS final results for each ADC */
-WindowStats adc0TestResults[ADC0_NUM_CH][TESTS_PER_WINDOW];
-WindowStats adc1TestResults[ADC1_NUM_CH][TESTS_PER_WINDOW];
-WindowStats adc2TestResults[ADC2_NUM_CH][TESTS_PER_WINDOW];
-WindowStats adc3TestResults[ADC3_NUM_CH][TESTS_PER_WINDOW];
+/* LEVEL 2: Persistent storage - KEEPS final results for each ADC.
+ * Placed in NOINIT RAM so a reset mid-sweep keeps completed work */
+#pragma DATA_SECTION(testStore, "sweepckpt:tests")
+#pragma DATA_SECTION(windowStore, "sweepckpt:windows")
+#pragma DATA_SECTION(sweepCheckpoint, "sweepckpt:header")
+TestStore testStore;
+WindowStore windowStore;
 
-WindowStats adc0WindowResults[ADC0_NUM_CH][NUM_WINDOWS];
-WindowStats adc1WindowResults[ADC1_NUM_CH][NUM_WINDOWS];
-WindowStats adc2WindowResults[ADC2_NUM_CH][NUM_WINDOWS];
-WindowStats adc3WindowResults[ADC3_NUM_CH][NUM_WINDOWS];
+const uint16_t resRowBase[NUM_ADCS] = {
+    0, ADC0_NUM_CH, ADC0_NUM_CH + ADC1_NUM_CH, ADC0_NUM_CH + ADC1_NUM_CH + ADC2_NUM_CH
+};
+
+SweepCheckpoint sweepCheckpoint;
+
+SweepConfig sweepCfg = {
+    ACQ_WINDOW_START, ACQ_WINDOW_END, 1,
+    TESTS_PER_WINDOW, RESULTS_BUFFER_SIZE, SAMPLE_DELAY_US,
+    { 0xFU, 0xFU, 0xFU, 0xFU },
+    OUTPUT_TABLE,
+    ADC_RESOLUTION_12BIT
+};
 
 volatile uint16_t systemSynced = 0;
 char uartBuffer[256];
 
+/* Latency measurements - reset every window */
+LatencyStats isrEntryLatency[NUM_ADCS];
+LatencyStats turnaroundLatency[NUM_ADCS];
+volatile uint32_t isrEntryStamp;
+
+/* Lost-sample accounting - reset every window */
+volatile DropStats adcDropStats[NUM_ADCS][MAX_CHANNELS];
+
+/* Achieved sample rate - reset every window */
+volatile RateStats adcRate[NUM_ADCS];
+
+/* PPB trigger-to-conversion delay - reset every window */
+volatile DelayStats adcDelayStats[NUM_ADCS][MAX_CHANNELS];
+
+/* PPB limit crossings - reset every window */
+volatile LimitEvent limitLog[LIMIT_LOG_SIZE];
+volatile uint16_t limitLogCount;
+volatile uint16_t limitHiCount[NUM_ADCS][MAX_CHANNELS];
+volatile uint16_t limitLoCount[NUM_ADCS][MAX_CHANNELS];
+static uint16_t limitArmed[NUM_ADCS][MAX_CHANNELS];    /* Event currently enabled */
+
+/* Scope capture - circular DMA target, own linker section in RAMGS6-11 */
+#pragma DATA_SECTION(scopeBuffer, "scopebuf")
+uint16_t scopeBuffer[SCOPE_DEPTH];
+uint16_t scopeTrigIndex;
+uint32_t scopeRateKsps;
+static uint16_t scopeAdc;
+
+/* Coherent average - 32-bit running sum per bin, result per channel */
+static uint32_t cohSum[COH_BINS];
+uint16_t cohWave[MAX_CHANNELS][COH_BINS];
+static uint16_t cohAdc, cohReps, cohNumCh;
+
+/* DAC step stimulus */
+volatile uint32_t stimSteps;
+static volatile bool stimNextHigh;
+
+/* Sweep schedule - all channels until the open/short pre-pass drops some */
+uint16_t chanActive[NUM_PHASES][NUM_ADCS] = {
+    { 0xFU, 0xFU, 0xFU, 0xFU },
+    { 0xFU, 0xFU, 0xFU, 0xFU }
+};
+ChannelState chanState[NUM_PHASES][NUM_ADCS][MAX_CHANNELS];
+static uint16_t sweepPhase;
+
+/* Converter setup - board.c powers up at SYSCLK/4, 12-bit single-ended */
+static ADC_SignalMode adcSignalMode = ADC_MODE_SINGLE_ENDED;
+static uint16_t adcResShift;                            /* Result bits above 12 */
+static uint16_t adcEarlyIntOffset = ADC_EARLY_INT_OFFSET;
+static uint16_t diffPinMask[NUM_PHASES][NUM_ADCS];      /* Channels on an even (pair) pin */
+
+/* Grid sweep */
+GridCell gridCells[GRID_MAX_CELLS];
+uint16_t gridNumCells;
+static GridPoint gridList[GRID_MAX_CELLS];              /* Shell "cell" entries */
+static uint16_t gridListCount;
+static uint16_t cellPhase;                              /* Phase of grid and rate cells */
+static uint16_t rateWindow;
+
+/* Channels actually swept: pre-pass result AND the shell's mask, and in
+ * differential mode only the channels that sit on a pair's even pin */
+static inline uint16_t scheduledMask(uint16_t adc)
+{
+    uint16_t m = chanActive[sweepPhase][adc] & sweepCfg.chanMask[adc];
+    if(adcSignalMode == ADC_MODE_DIFFERENTIAL) m &= diffPinMask[sweepPhase][adc];
+    return m;
+}
+
+/* ePWM skew - reset every window */
+SkewStats epwmSkew[NUM_EPWMS];
+
+/* Per-ADC SOC layout - ch index order matches the per-SOC ISRs below */
+const AdcPath adcPaths[NUM_ADCS] = {
+    { myADC0_BASE, myADC0_RESULT_BASE, INT_myADC0_1, INT_myADC0_1_INTERRUPT_ACK_GROUP,
+      ADC0_NUM_CH,
+      { ADC_SOC_NUMBER0, ADC_SOC_NUMBER1, ADC_SOC_NUMBER2 },
+      { { ADC_CH_ADCIN0, ADC_CH_ADCIN2, ADC_CH_ADCIN4 },
+        { ADC_CH_ADCIN1, ADC_CH_ADCIN3, ADC_CH_ADCIN5 } } },
+    { myADC1_BASE, myADC1_RESULT_BASE, INT_myADC1_1, INT_myADC1_1_INTERRUPT_ACK_GROUP,
+      ADC1_NUM_CH,
+      { ADC_SOC_NUMBER3, ADC_SOC_NUMBER8, ADC_SOC_NUMBER9 },
+      { { ADC_CH_ADCIN0, ADC_CH_ADCIN2, ADC_CH_ADCIN4 },
+        { ADC_CH_ADCIN1, ADC_CH_ADCIN3, ADC_CH_ADCIN5 } } },
+    { myADC2_BASE, myADC2_RESULT_BASE, INT_myADC2_1, INT_myADC2_1_INTERRUPT_ACK_GROUP,
+      ADC2_NUM_CH,
+      { ADC_SOC_NUMBER10, ADC_SOC_NUMBER11 },
+      { { ADC_CH_ADCIN2, ADC_CH_ADCIN4 },
+        { ADC_CH_ADCIN3, ADC_CH_ADCIN5 } } },
+    { myADC3_BASE, myADC3_RESULT_BASE, INT_myADC3_1, INT_myADC3_1_INTERRUPT_ACK_GROUP,
+      ADC3_NUM_CH,
+      { ADC_SOC_NUMBER4, ADC_SOC_NUMBER5, ADC_SOC_NUMBER6, ADC_SOC_NUMBER7 },
+      { { ADC_CH_ADCIN0, ADC_CH_ADCIN1, ADC_CH_ADCIN2, ADC_CH_ADCIN3 },
+        { ADC_CH_ADCIN4, ADC_CH_ADCIN5, ADC_CH_ADCIN14, ADC_CH_ADCIN15 } } }
+};
+
 /********************************************************************************
  * Helper Macros - Using shared arrays
  *******************************************************************************/
-#define ADC_ISR_BODY(ch, resultBase, socNum, adcBase, intNum, ackGroup)     \
+#define CYCLE_NOW()     CPUTimer_getTimerCount(CYCLE_TIMER_BASE)
+
+/* In early-interrupt mode the ISR is entered while the converter is still
+ * working - hold off until the result has latched */
+#if ADC_EARLY_INT
+#define ADC_EARLY_INT_HOLDOFF()                                             \
+    while((isrEntryStamp - CYCLE_NOW()) < adcEarlyIntOffset) { }
+#else
+#define ADC_EARLY_INT_HOLDOFF()
+#endif
+
+/* ADCSOCOVF1 has no driverlib accessor */
+#define ADC_SOC_OVF(base)       HWREGH((base) + ADC_O_SOCOVF1)
+#define ADC_CLEAR_SOC_OVF(base, mask)                                       \
+    do { EALLOW; HWREGH((base) + ADC_O_SOCOVFCLR1) = (mask); EDIS; } while(0)
+
+/* Count and clear trigger overflow (SOC) and interrupt overflow (ADCINT)
+ * for one channel before its flag is acknowledged */
+#define ADC_CHECK_OVERFLOW(adc, ch, adcBase, socNum, intNum)                \
+    do {                                                                    \
+        if(ADC_SOC_OVF(adcBase) & (1U << (socNum)))                         \
+        {                                                                   \
+            adcDropStats[adc][ch].overflow++;                               \
+            ADC_CLEAR_SOC_OVF((adcBase), 1U << (socNum));                   \
+        }                                                                   \
+        if(ADC_getInterruptOverflowStatus((adcBase), (intNum)))             \
+        {                                                                   \
+            adcDropStats[adc][ch].late++;                                   \
+            ADC_clearInterruptOverflowStatus((adcBase), (intNum));          \
+        }                                                                   \
+    } while(0)
+
+/* DLYSTAMP: SYSCLKs the SOC waited for the converter after its trigger */
+RAMFUNC static inline void recordDelay(volatile DelayStats* d, uint16_t cycles)
+{
+    uint16_t b = cycles / DELAY_BIN_CYCLES;
+    if(b >= DELAY_HIST_BINS) b = DELAY_HIST_BINS - 1;
+    d->bin[b]++;
+    d->sum += cycles;
+    d->count++;
+    if(cycles < d->min) d->min = cycles;
+    if(cycles > d->max) d->max = cycles;
+}
+
+/* Gap since this ADC's previous interrupt, which delivered n conversions */
+RAMFUNC static inline void recordSpacing(volatile RateStats* r, uint32_t now, uint16_t n)
+{
+    if(r->armed)
+    {
+        uint32_t gap = r->lastStamp - now;
+        r->cycles += gap;
+        r->conversions += n;
+        r->gaps++;
+        if(gap < r->minGap) r->minGap = gap;
+        if(gap > r->maxGap) r->maxGap = gap;
+    }
+    r->lastStamp = now;
+    r->armed = true;
+}
+
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+#define ADC_ROUND_CONVERSIONS(path)     (adcPaths[(path)].numCh * OVERSAMPLE_FACTOR)
+#else
+#define ADC_ROUND_CONVERSIONS(path)     (adcPaths[(path)].numCh)
+#endif
+
+/* Pause between sample rounds - 0 forces the next round straight away.
+ * samplePauseLoops is the SysCtl_delay count for sweepCfg.delayUs, set once
+ * per test so the loop does not run DEVICE_DELAY_US's long double math. */
+static uint32_t samplePauseLoops;
+#define SAMPLE_PAUSE()                                                      \
+    do { if(samplePauseLoops != 0U) SysCtl_delay(samplePauseLoops); } while(0)
+
+#if PPB_DELAY_MONITOR
+#define ADC_RECORD_DELAY(adc, ch, adcBase)                                  \
+    recordDelay(&adcDelayStats[adc][ch],                                    \
+                ADC_getPPBDelayTimeStamp((adcBase), (ADC_PPBNumber)(ch)));
+#else
+#define ADC_RECORD_DELAY(adc, ch, adcBase)
+#endif
+
+#define ADC_ISR_BODY(adc, ch, resultBase, socNum, adcBase, intNum, ackGroup) \
+    isrEntryStamp = CYCLE_NOW();                                            \
+    ADC_EARLY_INT_HOLDOFF()                                                 \
+    recordSpacing(&adcRate[adc], isrEntryStamp, 1U);                        \
     adcResults[ch][adcIndex[ch]] = ADC_readResult((resultBase), (socNum));  \
     adcIndex[ch]++;                                                         \
     adcSampleCount[ch]++;                                                   \
-    if(adcIndex[ch] >= RESULTS_BUFFER_SIZE) adcIndex[ch] = 0;               \
+    if(adcIndex[ch] >= sweepCfg.samples) adcIndex[ch] = 0;               \
+    adcDropStats[adc][ch].samples++;                                        \
+    ADC_RECORD_DELAY(adc, ch, adcBase)                                      \
+    ADC_CHECK_OVERFLOW(adc, ch, adcBase, socNum, intNum);                   \
     ADC_clearInterruptStatus((adcBase), (intNum));                          \
     Interrupt_clearACKGroup((ackGroup));                                    \
     adcComplete[ch] = 1;  
 
+/* End-of-sequence: one entry reads every tested SOC of the ADC; completion
+ * is signalled on adcComplete[0] */
+#define ADC_EOS_ISR_BODY(path)                                              \
+    isrEntryStamp = CYCLE_NOW();                                            \
+    ADC_EARLY_INT_HOLDOFF()                                                 \
+    recordSpacing(&adcRate[(path)], isrEntryStamp, ADC_ROUND_CONVERSIONS(path)); \
+    readAllResults(&adcPaths[(path)]);                                      \
+    checkRoundOverflow((path));                                             \
+    ADC_clearInterruptStatus(adcPaths[(path)].base, ADC_INT_NUMBER1);       \
+    Interrupt_clearACKGroup(adcPaths[(path)].ackGroup);                     \
+    adcComplete[0] = 1;
+
 /********************************************************************************
  * UART Helpers
  *******************************************************************************/
+#if TASK_SCHEDULER
+/* Transmit ring - writers queue, uartTxPump moves it into the SCI FIFO */
+static char uartTx[UART_TX_SIZE];
+static uint16_t uartTxHead;
+static uint16_t uartTxTail;
+static bool uartLineStart = true;   /* Last char queued was '\n' */
+
+/* Fill the 16-deep TX FIFO from the ring without waiting */
+static void uartTxPump(void)
+{
+    while(uartTxTail != uartTxHead && SCI_getTxFIFOStatus(mySCI0_BASE) != SCI_FIFO_TX16)
+    {
+        SCI_writeCharNonBlocking(mySCI0_BASE, (uint16_t)uartTx[uartTxTail & (UART_TX_SIZE - 1U)]);
+        uartTxTail++;
+    }
+}
+#endif
+
+void UART_writeChar(char c)
+{
+#if TASK_SCHEDULER
+    /* Full ring: drain it here rather than yield, so no task runs mid-string */
+    while((uint16_t)(uartTxHead - uartTxTail) >= UART_TX_SIZE) uartTxPump();
+    uartTx[uartTxHead & (UART_TX_SIZE - 1U)] = c;
+    uartTxHead++;
+    uartLineStart = (c == '\n');
+#else
+    SCI_writeCharBlockingFIFO(mySCI0_BASE, c);
+#endif
+}
+
 void UART_writeString(const char* str)
 {
     uint16_t i = 0;
     while(str[i] != '\0')
     {
-        SCI_writeCharBlockingFIFO(mySCI0_BASE, str[i]);
+        UART_writeChar(str[i]);
         i++;
     }
+#if TASK_SCHEDULER
+    uartTxPump();
+#endif
+}
+
+/* Room for a whole uartBuffer line at a line boundary - background output
+ * then neither blocks nor splits a line, typed shell input included */
+bool UART_lineFree(void)
+{
+#if TASK_SCHEDULER
+    return uartLineStart &&
+           UART_TX_SIZE - (uint16_t)(uartTxHead - uartTxTail) >= sizeof(uartBuffer);
+#else
+    return true;
+#endif
 }
 
 char UART_readChar(void)
 {
+#if TASK_SCHEDULER
+    while(SCI_getRxFIFOStatus(mySCI0_BASE) == SCI_FIFO_RX0) schedYield();
+#endif
     return SCI_readCharBlockingFIFO(mySCI0_BASE);
 }
 
 void waitForKeyPress(void)
 {
-    char c = SCI_readCharBlockingFIFO(mySCI0_BASE);
+    char c = UART_readChar();
     sprintf(uartBuffer, "Key pressed: '%c'\r\n\r\n", c);
     UART_writeString(uartBuffer);
 }
 
 void delayMs(uint16_t ms)
 {
+#if TASK_SCHEDULER
+    waitUs((uint32_t)ms * 1000UL);
+#else
     uint16_t i;
     for(i = 0; i < ms; i++) DEVICE_DELAY_US(1000);
+#endif
+}
+
+/* Settling wait - at least us; a background task may stretch it */
+void waitUs(uint32_t us)
+{
+#if TASK_SCHEDULER
+    uint32_t start = CYCLE_NOW();
+    uint32_t span = us * (DEVICE_SYSCLK_FREQ / 1000000UL);
+    while(start - CYCLE_NOW() < span) schedYield();
+#else
+    /* DEVICE_DELAY_US's count in integer math - us is not a constant here */
+    SysCtl_delay((us * (DEVICE_SYSCLK_FREQ / 1000000UL) - 9UL) / 5UL);
+#endif
+}
+
+/********************************************************************************
+ * Cycle Timestamps - CPU Timer 1 free-running at SYSCLK
+ *******************************************************************************/
+void initCycleTimer(void)
+{
+    CPUTimer_stopTimer(CYCLE_TIMER_BASE);
+    CPUTimer_setPeriod(CYCLE_TIMER_BASE, 0xFFFFFFFFUL);
+    CPUTimer_setPreScaler(CYCLE_TIMER_BASE, 0);
+    CPUTimer_reloadTimerCounter(CYCLE_TIMER_BASE);
+    CPUTimer_setEmulationMode(CYCLE_TIMER_BASE, CPUTIMER_EMULATIONMODE_RUNFREE);
+    CPUTimer_clearOverflowFlag(CYCLE_TIMER_BASE);
+    CPUTimer_startTimer(CYCLE_TIMER_BASE);
+}
+
+/* CYCLE_NOW plus the count of 2^32-cycle (~21.5 s) reloads before it. TIF
+ * latches one reload, so a caller must sample at least once per wrap -
+ * every log write and scheduler yield does. Foreground only. */
+static uint16_t cycleWraps;
+
+uint32_t cycleStamp(uint16_t* wraps)
+{
+    uint32_t now = CYCLE_NOW();
+
+    if(CPUTimer_getTimerOverflowStatus(CYCLE_TIMER_BASE))
+    {
+        CPUTimer_clearOverflowFlag(CYCLE_TIMER_BASE);
+        cycleWraps++;
+        now = CYCLE_NOW();      /* Re-read so now and the count agree */
+    }
+    *wraps = cycleWraps;
+    return now;
+}
+
+/* Cycles elapsed since the counter started, from a cycleStamp pair */
+static uint64_t cycleElapsed(uint16_t wraps, uint32_t stamp)
+{
+    return ((uint64_t)wraps << 32) + (0xFFFFFFFFUL - stamp);
+}
+
+/********************************************************************************
+ * Cooperative scheduler - tasks run from schedYield inside waits, never
+ * from an interrupt, and none may block on the UART
+ *******************************************************************************/
+static void heartbeatTask(void)
+{
+    GPIO_togglePin(HEARTBEAT_GPIO);
+}
+
+static SchedTask schedTasks[] = {
+#if TASK_SCHEDULER
+    { uartTxPump, 0, 0 },
+#endif
+    { heartbeatTask, HEARTBEAT_MS, 0 },
+#if EVENT_LOG
+    { drainEventLogStep, 0, 0 },
+#endif
+};
+
+void initScheduler(void)
+{
+    uint16_t t;
+
+    GPIO_setPadConfig(HEARTBEAT_GPIO, GPIO_PIN_TYPE_STD);
+    GPIO_setPinConfig(GPIO_PIN_MUX(HEARTBEAT_GPIO));
+    GPIO_setDirectionMode(HEARTBEAT_GPIO, GPIO_DIR_MODE_OUT);
+    GPIO_setControllerCore(HEARTBEAT_GPIO, GPIO_CORE_CPU1);
+    for(t = 0; t < sizeof(schedTasks) / sizeof(schedTasks[0]); t++)
+        schedTasks[t].last = CYCLE_NOW();
+}
+
+void schedYield(void)
+{
+    static bool busy = false;
+    uint32_t now;
+    uint16_t t, wraps;
+
+    if(busy) return;        /* A task that waits does not re-enter the others */
+    busy = true;
+    (void)cycleStamp(&wraps);   /* Keeps the log clock's wrap count current */
+    for(t = 0; t < sizeof(schedTasks) / sizeof(schedTasks[0]); t++)
+    {
+        SchedTask* k = &schedTasks[t];
+        now = CYCLE_NOW();
+        if(k->last - now < (uint32_t)k->periodMs * SCHED_CYCLES_PER_MS) continue;
+        k->last = now;
+        k->run();
+    }
+    busy = false;
+}
+
+void resetLatencyStats(void)
+{
+    uint16_t a;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        isrEntryLatency[a].min = 0xFFFFFFFFUL;
+        isrEntryLatency[a].max = 0;
+        isrEntryLatency[a].sum = 0;
+        isrEntryLatency[a].count = 0;
+        turnaroundLatency[a] = isrEntryLatency[a];
+    }
+}
+
+RAMFUNC void recordLatency(LatencyStats* s, uint32_t cycles)
+{
+    if(cycles < s->min) s->min = cycles;
+    if(cycles > s->max) s->max = cycles;
+    s->sum += cycles;
+    s->count++;
+}
+
+/********************************************************************************
+ * Lost-sample accounting
+ *******************************************************************************/
+void resetDropStats(void)
+{
+    uint16_t a, ch;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        for(ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            adcDropStats[a][ch].samples = 0;
+            adcDropStats[a][ch].overflow = 0;
+            adcDropStats[a][ch].late = 0;
+            adcDropStats[a][ch].timeout = 0;
+        }
+        ADC_CLEAR_SOC_OVF(adcPaths[a].base, 0xFFFFU);
+        ADC_clearInterruptOverflowStatus(adcPaths[a].base, ADC_INT_NUMBER1);
+        ADC_clearInterruptOverflowStatus(adcPaths[a].base, ADC_INT_NUMBER2);
+        ADC_clearInterruptOverflowStatus(adcPaths[a].base, ADC_INT_NUMBER3);
+        ADC_clearInterruptOverflowStatus(adcPaths[a].base, ADC_INT_NUMBER4);
+    }
+}
+
+/********************************************************************************
+ * Achieved sample rate - ISR-to-ISR spacing per ADC, including the force,
+ * poll and pause overhead of the acquisition loop
+ *******************************************************************************/
+void resetRateStats(void)
+{
+    uint16_t a;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        adcRate[a].cycles = 0;
+        adcRate[a].conversions = 0;
+        adcRate[a].gaps = 0;
+        adcRate[a].minGap = 0xFFFFFFFFUL;
+        adcRate[a].maxGap = 0;
+        adcRate[a].armed = false;
+    }
+}
+
+/* Conversions per millisecond */
+uint32_t achievedKsps(uint16_t adc)
+{
+    volatile RateStats* r = &adcRate[adc];
+    if(r->cycles == 0) return 0;
+    return (uint32_t)((float)r->conversions * (float)(DEVICE_SYSCLK_FREQ / 1000UL) / (float)r->cycles);
+}
+
+void displayRateStats(void)
+{
+    uint16_t a;
+    UART_writeString("  Rate   achieved MSPS | gap per interrupt min/avg/max [cyc]\r\n");
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        volatile RateStats* r = &adcRate[a];
+        uint32_t ksps = achievedKsps(a);
+        sprintf(uartBuffer, "  ADC%u  %2lu.%03lu | %6lu %6lu %6lu\r\n", a,
+                (unsigned long)(ksps / 1000UL), (unsigned long)(ksps % 1000UL),
+                (unsigned long)(r->cycles ? r->minGap : 0),
+                (unsigned long)(r->gaps ? r->cycles / r->gaps : 0),
+                (unsigned long)r->maxGap);
+        UART_writeString(uartBuffer);
+    }
 }
 
 /********************************************************************************
@@ -72,7 +522,7 @@ void delayMs(uint16_t ms)
 void stopEPWMs(void)
 {
     SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
-    DEVICE_DELAY_US(100);
+    waitUs(100);
     EPWM_setTimeBaseCounter(myEPWM0_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM1_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM2_BASE, 0);
@@ -81,6 +531,9 @@ void stopEPWMs(void)
     EPWM_setTimeBaseCounter(myEPWM5_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM6_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM7_BASE, 0);
+#if STIM_DAC
+    resetStimulus();
+#endif
     systemSynced = 0;
 }
 
@@ -94,6 +547,9 @@ void startPWM(void)
     EPWM_setTimeBaseCounter(myEPWM5_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM6_BASE, 0);
     EPWM_setTimeBaseCounter(myEPWM7_BASE, 0);
+#if STIM_DAC
+    resetStimulus();
+#endif
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER3);
@@ -110,49 +566,368 @@ void startPWM(void)
     systemSynced = 1;
 }
 
+/* ePWM1..6 SOCA/SOCB pace the sweep SOCs - masked during scope captures,
+ * and always off in EOS / oversample mode */
+void setSweepADCTriggers(bool enable)
+{
+    static const uint32_t bases[] = {
+        myEPWM0_BASE, myEPWM1_BASE, myEPWM2_BASE, myEPWM3_BASE, myEPWM4_BASE, myEPWM5_BASE
+    };
+    uint16_t e;
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    /* Rounds are forced by acquireEOS only - an ePWM conversion of the last
+     * SOC would end a round early and move the round-robin pointer */
+    enable = false;
+#endif
+    for(e = 0; e < sizeof(bases) / sizeof(bases[0]); e++)
+    {
+        if(enable)
+        {
+            EPWM_enableADCTrigger(bases[e], EPWM_SOC_A);
+            EPWM_enableADCTrigger(bases[e], EPWM_SOC_B);
+        }
+        else
+        {
+            EPWM_disableADCTrigger(bases[e], EPWM_SOC_A);
+            EPWM_disableADCTrigger(bases[e], EPWM_SOC_B);
+        }
+    }
+}
+
 /********************************************************************************
- * Statistics
+ * DAC Step Stimulus - shadow values latch on ePWM9 zero (PWMSYNC), so the
+ * step timing is set by the time base, not by stimulusISR latency. The ISR
+ * only queues the level for the next edge.
  *******************************************************************************/
-float calculateStdDev(volatile uint16_t* results, uint16_t avg)
+static const uint32_t stimDacBases[3] = { DACA_BASE, DACB_BASE, DACC_BASE };
+
+RAMFUNC static inline void setStimulusShadow(uint16_t code)
 {
-    uint16_t i;
-    float variance = 0.0f;
-    float avgF = (float)avg;
-    float result = 0.0f;
+    uint16_t d;
+    for(d = 0; d < 3U; d++)
+        if(STIM_DAC_MASK & (1U << d)) DAC_setShadowValue(stimDacBases[d], code);
+}
+
+void initStimulus(void)
+{
+    uint16_t d;
+
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM9);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_DACA);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_DACB);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_DACC);
+
+    /* Same TBCLK as the sweep ePWMs; held by TBCLKSYNC until startPWM */
+    EPWM_setClockPrescaler(STIM_EPWM_BASE, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_2);
+    EPWM_setTimeBasePeriod(STIM_EPWM_BASE, STIM_EPWM_PERIOD - 1U);
+    EPWM_setTimeBaseCounterMode(STIM_EPWM_BASE, EPWM_COUNTER_MODE_UP);
+    EPWM_disablePhaseShiftLoad(STIM_EPWM_BASE);
+    HRPWM_setSyncPulseSource(STIM_EPWM_BASE, HRPWM_PWMSYNC_SOURCE_ZERO);
+    EPWM_setInterruptSource(STIM_EPWM_BASE, EPWM_INT_TBCTR_ZERO);
+    EPWM_setInterruptEventCount(STIM_EPWM_BASE, 1);
+    EPWM_enableInterrupt(STIM_EPWM_BASE);
+
+    for(d = 0; d < 3U; d++)
+    {
+        if(!(STIM_DAC_MASK & (1U << d))) continue;
+        DAC_setReferenceVoltage(stimDacBases[d], DAC_REF_ADC_VREFHI);
+        DAC_setPWMSyncSignal(stimDacBases[d], STIM_EPWM_NUM);
+        DAC_setLoadMode(stimDacBases[d], DAC_LOAD_SYSCLK);
+        DAC_setShadowValue(stimDacBases[d], STIM_LO_CODE);
+        DAC_enableOutput(stimDacBases[d]);
+    }
+    waitUs(10);             /* DAC power-up */
+
+    Interrupt_register(INT_EPWM9, &stimulusISR);
+    Interrupt_enable(INT_EPWM9);
+    resetStimulus();
+}
+
+/* Called with the time base stopped: output low now, high at the first
+ * ePWM9 zero = first EPWM1A rising edge */
+void resetStimulus(void)
+{
+    uint16_t d;
+
+    EPWM_setTimeBaseCounter(STIM_EPWM_BASE, STIM_EPWM_OFFSET);
+    for(d = 0; d < 3U; d++)
+    {
+        if(!(STIM_DAC_MASK & (1U << d))) continue;
+        DAC_setLoadMode(stimDacBases[d], DAC_LOAD_SYSCLK);
+        DAC_setShadowValue(stimDacBases[d], STIM_LO_CODE);
+        DAC_setLoadMode(stimDacBases[d], DAC_LOAD_PWMSYNC);
+        DAC_setShadowValue(stimDacBases[d], STIM_HI_CODE);
+    }
+    stimNextHigh = true;
+    stimSteps = 0;
+    EPWM_clearEventTriggerInterruptFlag(STIM_EPWM_BASE);
+}
+
+RAMFUNC __interrupt void stimulusISR(void)
+{
+    stimNextHigh = !stimNextHigh;
+    setStimulusShadow(stimNextHigh ? STIM_HI_CODE : STIM_LO_CODE);
+    stimSteps++;
+    EPWM_clearEventTriggerInterruptFlag(STIM_EPWM_BASE);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP3);
+}
+
+/********************************************************************************
+ * ePWM Skew Monitor - eCAP counters share one sync, so absolute timestamps
+ * of the EPWMxA rising edges compare directly. Input X-BAR INPUT7..12 feed
+ * eCAP1..6; eCAP1 always watches EPWM1A.
+ *******************************************************************************/
+static const uint16_t epwmPins[NUM_EPWMS] = {
+    myEPWM0_EPWMA_GPIO, myEPWM1_EPWMA_GPIO, myEPWM2_EPWMA_GPIO, myEPWM3_EPWMA_GPIO,
+    myEPWM4_EPWMA_GPIO, myEPWM5_EPWMA_GPIO, myEPWM6_EPWMA_GPIO, myEPWM7_EPWMA_GPIO
+};
+
+static const uint32_t ecapBases[NUM_ECAPS] = {
+    ECAP1_BASE, ECAP2_BASE, ECAP3_BASE, ECAP4_BASE, ECAP5_BASE, ECAP6_BASE
+};
+
+#define ECAP_ALL_EVENTS     (ECAP_ISR_SOURCE_CAPTURE_EVENT_1 | ECAP_ISR_SOURCE_CAPTURE_EVENT_2 | \
+                             ECAP_ISR_SOURCE_CAPTURE_EVENT_3 | ECAP_ISR_SOURCE_CAPTURE_EVENT_4)
+
+void initSkewMonitor(void)
+{
+    uint16_t e;
+    ECAP_Events ev;
+
+    /* eCAP1 -> 2 -> 3 are chained; hang eCAP4 -> 5 -> 6 off eCAP1 too */
+    SysCtl_setSyncInputConfig(SYSCTL_SYNC_IN_ECAP4, SYSCTL_SYNC_IN_SRC_ECAP1SYNCOUT);
+
+    for(e = 0; e < NUM_ECAPS; e++)
+    {
+        uint32_t base = ecapBases[e];
+        ECAP_disableInterrupt(base, ECAP_ALL_EVENTS);
+        ECAP_clearInterrupt(base, ECAP_ALL_EVENTS);
+        ECAP_disableTimeStampCapture(base);
+        ECAP_stopCounter(base);
+        ECAP_enableCaptureMode(base);
+        ECAP_setCaptureMode(base, ECAP_ONE_SHOT_CAPTURE_MODE, ECAP_EVENT_4);
+        for(ev = ECAP_EVENT_1; ev <= ECAP_EVENT_4; ev++)
+        {
+            ECAP_setEventPolarity(base, ev, ECAP_EVNT_RISING_EDGE);
+            ECAP_disableCounterResetOnEvent(base, ev);
+        }
+        ECAP_setEventPrescaler(base, 0);
+        ECAP_setPhaseShiftCount(base, 0);
+        ECAP_enableLoadCounter(base);
+        ECAP_setSyncOutMode(base, ECAP_SYNC_OUT_SYNCI);
+        ECAP_enableTimeStampCapture(base);
+        ECAP_startCounter(base);
+    }
+
+    /* One software sync zeroes all six counters, then ignore EPWM1 SYNCO so
+     * a sync pulse can never land between two edges being compared */
+    ECAP_loadCounter(ECAP1_BASE);
+    for(e = 0; e < NUM_ECAPS; e++) ECAP_disableLoadCounter(ecapBases[e]);
+}
 
-    for(i = 0; i < RESULTS_BUFFER_SIZE; i++)
+void resetSkewStats(void)
+{
+    uint16_t m;
+    for(m = 0; m < NUM_EPWMS; m++)
+    {
+        epwmSkew[m].min = 0x7FFFFFFFL;
+        epwmSkew[m].max = -0x7FFFFFFFL;
+        epwmSkew[m].sum = 0;
+        epwmSkew[m].driftMax = 0;
+        epwmSkew[m].count = 0;
+        epwmSkew[m].missed = 0;
+    }
+}
+
+/* Restart the ePWMs once with eCAP1 on EPWM1A and eCAP2.. on epwm[1..n-1] */
+static void captureSkewGroup(const uint16_t* epwm, uint16_t n)
+{
+    uint32_t t[NUM_ECAPS][SKEW_EDGES];
+    uint16_t done = 0;
+    uint16_t all = (1U << n) - 1U;
+    uint16_t e, k;
+    uint32_t us;
+
+    stopEPWMs();
+    for(e = 0; e < n; e++)
+    {
+        XBAR_setInputPin((XBAR_InputNum)(XBAR_INPUT7 + e), epwmPins[epwm[e]]);
+        ECAP_clearInterrupt(ecapBases[e], ECAP_ALL_EVENTS);
+        ECAP_reArm(ecapBases[e]);
+    }
+    startPWM();
+
+    for(us = 0; us < SKEW_TIMEOUT_US && done != all; us += 10)
+    {
+        for(e = 0; e < n; e++)
+            if(ECAP_getInterruptSource(ecapBases[e]) & ECAP_ISR_SOURCE_CAPTURE_EVENT_4)
+                done |= 1U << e;
+        waitUs(10);
+    }
+    stopEPWMs();
+
+    for(e = 0; e < n; e++)
+        for(k = 0; k < SKEW_EDGES; k++)
+            t[e][k] = ECAP_getEventTimeStamp(ecapBases[e], (ECAP_Events)k);
+
+    for(e = 1; e < n; e++)
+    {
+        SkewStats* st = &epwmSkew[epwm[e]];
+        int32_t first, drift;
+
+        if(!(done & 1U) || !(done & (1U << e)))
+        {
+            st->missed++;
+            continue;
+        }
+        first = (int32_t)(t[e][0] - t[0][0]);
+        drift = (int32_t)(t[e][SKEW_EDGES - 1] - t[0][SKEW_EDGES - 1]) - first;
+        if(drift < 0) drift = -drift;
+        if(first < st->min) st->min = first;
+        if(first > st->max) st->max = first;
+        if(drift > st->driftMax) st->driftMax = drift;
+        st->sum += first;
+        st->count++;
+    }
+}
+
+void measureSkew(void)
+{
+    static const uint16_t group1[NUM_ECAPS] = { 0, 1, 2, 3, 4, 5 };
+    static const uint16_t group2[3] = { 0, 6, 7 };
+    uint16_t r;
+
+    for(r = 0; r < SKEW_RESTARTS; r++)
     {
-        float d = (float)results[i] - avgF;
-        variance += d * d;
+        captureSkewGroup(group1, NUM_ECAPS);
+        captureSkewGroup(group2, 3);
     }
-    variance /= RESULTS_BUFFER_SIZE;
+}
 
-    if(variance > 0.01f)
+void displaySkewStats(void)
+{
+    uint16_t m;
+    UART_writeString("  Skew vs EPWM1A (cycles): min avg max drift miss\r\n");
+    for(m = 1; m < NUM_EPWMS; m++)
     {
-        result = variance / 2.0f;
-        for(i = 0; i < 10; i++)
-            if(result > 0.0f) result = (result + variance / result) / 2.0f;
+        SkewStats* st = &epwmSkew[m];
+        sprintf(uartBuffer, "  EPWM%u  %6ld %6ld %6ld  %4ld  %u\r\n", m + 1,
+                (long)(st->count ? st->min : 0),
+                (long)(st->count ? st->sum / st->count : 0),
+                (long)(st->count ? st->max : 0),
+                (long)st->driftMax, st->missed);
+        UART_writeString(uartBuffer);
     }
-    return result;
 }
 
-void calculateStatistics(volatile uint16_t* results, WindowStats* stats)
+/********************************************************************************
+ * Statistics
+ *******************************************************************************/
+/* One pass, integer only: var = (n*sum(x^2) - sum(x)^2) / n^2 is exact
+ * before the final division, so no rounding from the truncated average */
+RAMFUNC void calculateStatistics(volatile uint16_t* results, WindowStats* stats)
 {
     uint16_t i;
+    uint16_t n = sweepCfg.samples;
     uint32_t sum = 0;
+    uint64_t sumSq = 0;
+    uint64_t var;
     stats->min = 0xFFFF;
     stats->max = 0;
 
-    for(i = 0; i < RESULTS_BUFFER_SIZE; i++)
+    for(i = 0; i < n; i++)
     {
         uint16_t v = results[i];
         sum += v;
+        sumSq += (uint32_t)v * v;
         if(v < stats->min) stats->min = v;
         if(v > stats->max) stats->max = v;
     }
-    stats->avg = (uint16_t)(sum / RESULTS_BUFFER_SIZE);
+    stats->avg = (uint16_t)(sum / n);
     stats->range = stats->max - stats->min;
-    stats->stdDev = calculateStdDev(results, stats->avg);
+    var = (((uint64_t)n * sumSq - (uint64_t)sum * sum) << VAR_FRAC_BITS) / ((uint32_t)n * n);
+    stats->var = (var > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)var;    /* StdDev >= 4096 */
+    stats->valid = true;
+}
+
+/* StdDev x100 of a store variance, rounded down - bitwise integer sqrt */
+uint32_t varStdX100(uint32_t var)
+{
+    uint64_t v = ((uint64_t)var * 10000U) >> VAR_FRAC_BITS;
+    uint64_t bit = (uint64_t)1 << 62;
+    uint64_t root = 0;
+
+    while(bit > v) bit >>= 2;
+    while(bit != 0)
+    {
+        if(v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/* The same, saturated for the 16-bit stdX100 fields of the log and grid */
+static inline uint16_t varStdX100Sat(uint32_t var)
+{
+    uint32_t sd = varStdX100(var);
+    return (sd > 65535UL) ? 65535U : (uint16_t)sd;
+}
+
+/********************************************************************************
+ * Result store access - rows are RES_ROW(adc, ch)
+ *******************************************************************************/
+static inline bool validBit(const uint16_t* bits, uint16_t i)
+{
+    return (bits[i >> 4] >> (i & 15U)) & 1U;
+}
+
+static inline void putValidBit(uint16_t* bits, uint16_t i, bool valid)
+{
+    if(valid) bits[i >> 4] |= 1U << (i & 15U);
+    else      bits[i >> 4] &= ~(1U << (i & 15U));
+}
+
+void storeTestResult(uint16_t row, uint16_t test, const WindowStats* s)
+{
+    testStore.min[row][test] = s->min;
+    testStore.max[row][test] = s->max;
+    testStore.avg[row][test] = s->avg;
+    testStore.var[row][test] = s->var;
+    putValidBit(testStore.valid[row], test, s->valid);
+}
+
+void setTestValid(uint16_t row, uint16_t test, bool valid)
+{
+    putValidBit(testStore.valid[row], test, valid);
+}
+
+void loadTestResult(uint16_t row, uint16_t test, WindowStats* s)
+{
+    s->min = testStore.min[row][test];
+    s->max = testStore.max[row][test];
+    s->avg = testStore.avg[row][test];
+    s->range = s->max - s->min;
+    s->var = testStore.var[row][test];
+    s->valid = validBit(testStore.valid[row], test);
+}
+
+void loadWindowResult(uint16_t row, uint16_t w, WindowStats* s)
+{
+    s->min = windowStore.min[row][w];
+    s->max = windowStore.max[row][w];
+    s->avg = windowStore.avg[row][w];
+    s->range = s->max - s->min;
+    s->var = windowStore.var[row][w];
+    s->valid = validBit(windowStore.valid[row], w);
 }
 
 /********************************************************************************
@@ -160,10 +935,11 @@ void calculateStatistics(volatile uint16_t* results, WindowStats* stats)
  *******************************************************************************/
 void displayTestResult(uint16_t testNum, const char* label, WindowStats* stats)
 {
-    uint16_t sdI = (uint16_t)stats->stdDev;
-    uint16_t sdF = (uint16_t)((stats->stdDev - sdI) * 100);
+    uint32_t sd = varStdX100(stats->var);
+    uint16_t sdI = (uint16_t)(sd / 100U);
+    uint16_t sdF = (uint16_t)(sd % 100U);
     sprintf(uartBuffer,
-            "  [%2u] %-10s Avg:%4u Range:%3u StdDev:%u.%02u\r\n",
+            "  [%2u] %-10s Avg:%5u Range:%5u StdDev:%u.%02u\r\n",
             testNum, label,
             stats->avg, stats->range, sdI, sdF);
     UART_writeString(uartBuffer);
@@ -171,15 +947,70 @@ void displayTestResult(uint16_t testNum, const char* label, WindowStats* stats)
 
 static void printTableRow(uint16_t winCycles, WindowStats* s)
 {
-    uint16_t sdI = (uint16_t)s->stdDev;
-    uint16_t sdF = (uint16_t)((s->stdDev - sdI) * 100);
+    uint32_t sd = varStdX100(s->var);
+    uint16_t sdI = (uint16_t)(sd / 100U);
+    uint16_t sdF = (uint16_t)(sd % 100U);
+    if(!s->valid)
+    {
+        sprintf(uartBuffer, "  %3u   | %4uns |  --- INVALID (timeouts) ---\r\n",
+                winCycles, winCycles * 5);
+        UART_writeString(uartBuffer);
+        return;
+    }
     sprintf(uartBuffer,
-            "   %2u   | %4uns | %4u | %4u | %4u |  %3u  | %2u.%02u\r\n",
+            "  %3u   | %4uns | %5u | %5u | %5u | %5u | %3u.%02u\r\n",
             winCycles, winCycles * 5,
             s->min, s->max, s->avg, s->range, sdI, sdF);
     UART_writeString(uartBuffer);
 }
 
+static void printWindowRow(uint16_t row, uint16_t w)
+{
+    WindowStats s;
+    loadWindowResult(row, w, &s);
+    printTableRow(windowCycles(w), &s);
+}
+
+static void printLatencyRow(uint16_t adc)
+{
+    LatencyStats* e = &isrEntryLatency[adc];
+    LatencyStats* t = &turnaroundLatency[adc];
+    sprintf(uartBuffer, "  ADC%u  %6lu %6lu %6lu  | %6lu %6lu %6lu\r\n", adc,
+            (unsigned long)(e->count ? e->min : 0),
+            (unsigned long)(e->count ? e->sum / e->count : 0),
+            (unsigned long)e->max,
+            (unsigned long)(t->count ? t->min : 0),
+            (unsigned long)(t->count ? t->sum / t->count : 0),
+            (unsigned long)t->max);
+    UART_writeString(uartBuffer);
+}
+
+void displayLatencyStats(void)
+{
+    uint16_t a;
+    UART_writeString("  Latency [cyc] force->ISR min/avg/max | force->result min/avg/max\r\n");
+    for(a = 0; a < NUM_ADCS; a++) printLatencyRow(a);
+}
+
+void displayDropStats(void)
+{
+    uint16_t a, ch;
+    UART_writeString("  Drops  ch: samples ovf late tmo\r\n");
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        sprintf(uartBuffer, "  ADC%u ", a);
+        UART_writeString(uartBuffer);
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            volatile DropStats* d = &adcDropStats[a][ch];
+            sprintf(uartBuffer, " %u:%5lu %u %u %u ", ch, (unsigned long)d->samples,
+                    d->overflow, d->late, d->timeout);
+            UART_writeString(uartBuffer);
+        }
+        UART_writeString("\r\n");
+    }
+}
+
 static void printTableHeader(const char* adcLabel, const char* chLabel)
 {
     UART_writeString("\r\n");
@@ -187,47 +1018,174 @@ static void printTableHeader(const char* adcLabel, const char* chLabel)
     sprintf(uartBuffer, "  %s  %-10s  ACQUISITION WINDOW SWEEP\r\n",
             adcLabel, chLabel);
     UART_writeString(uartBuffer);
+    UART_writeString(sweepCfg.resolution == ADC_RESOLUTION_16BIT
+                     ? "  16-bit differential 0..65535 - pin is +, pin+1 is -\r\n"
+                     : "  12-bit single-ended 0..4095\r\n");
     UART_writeString("========================================================\r\n");
-    UART_writeString(" Cycles |  Time  | Min  | Max  | Avg  | Range | StdDev\r\n");
-    UART_writeString("--------|--------|------|------|------|-------|--------\r\n");
+    UART_writeString(" Cycles |  Time  |  Min  |  Max  |  Avg  | Range | StdDev\r\n");
+    UART_writeString("--------|--------|-------|-------|-------|-------|--------\r\n");
 }
 
 /********************************************************************************
- * Acquisition Window Setters
+ * Deferred event log - the sweep only copies a record into the ring; UART
+ * formatting waits for drainEventLog between windows
  *******************************************************************************/
-void setAcquisitionWindowADC0(uint16_t cycles)
-{
-    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_EPWM1_SOCA, ADC_CH_ADCIN0, cycles);
-    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER1, ADC_TRIGGER_EPWM1_SOCB, ADC_CH_ADCIN2, cycles);
-    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER2, ADC_TRIGGER_EPWM2_SOCA, ADC_CH_ADCIN4, cycles);
-    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER1);
-    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER2);
-    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER3);
-    DEVICE_DELAY_US(100);
-}
+LogRecord eventLog[LOG_SIZE];
+uint32_t logHead;
+uint16_t logVerbosity = LOG_VERBOSITY;
+static uint32_t logDrained;
+static uint64_t logT0;          /* cycleElapsed at resetEventLog */
+static uint16_t logWindow;      /* Window of the records being written */
+
+static const uint16_t logLevel[] = { LOG_LEVEL_TEST, LOG_LEVEL_WINDOW, LOG_LEVEL_ERROR };
+
+void resetEventLog(void)
+{
+    logHead = 0;
+    logDrained = 0;
+    {
+        uint16_t wraps;
+        uint32_t now = cycleStamp(&wraps);
+        logT0 = cycleElapsed(wraps, now);
+    }
+}
+
+/* s may be NULL for records without statistics */
+void logStats(LogKind kind, uint16_t adc, uint16_t ch, uint16_t window, uint16_t test,
+              const WindowStats* s)
+{
+    LogRecord* r = &eventLog[(uint16_t)logHead & (LOG_SIZE - 1U)];
+
+    r->stamp = cycleStamp(&r->wraps);
+    r->kind = kind;
+    r->src = (adc << 8) | ch;
+    r->window = window;
+    r->test = test;
+    r->min = s ? s->min : 0;
+    r->max = s ? s->max : 0;
+    r->avg = s ? s->avg : 0;
+    r->range = s ? s->range : 0;
+    r->stdX100 = (s == NULL) ? 0 : varStdX100Sat(s->var);
+    logHead++;
+}
+
+static void printLogRecord(const LogRecord* r)
+{
+    /* Time since the sweep started, ms.us - exact over the 21.5 s wrap */
+    uint64_t us = (cycleElapsed(r->wraps, r->stamp) - logT0) / (DEVICE_SYSCLK_FREQ / 1000000UL);
+    unsigned long ms = (unsigned long)(us / 1000U);
+    uint16_t usFrac = (uint16_t)(us % 1000U);
+    uint16_t adc = r->src >> 8;
+    uint16_t ch = r->src & 0xFFU;
+
+    if(r->kind == LOG_RETRY)
+        sprintf(uartBuffer, "  %8lu.%03u ms ADC%u     win %3u test %2u attempt %u failed\r\n",
+                ms, usFrac, adc, r->window, r->test, ch + 1U);
+    else
+        sprintf(uartBuffer, "  %8lu.%03u ms ADC%u ch%u win %3u %s%2u Min:%5u Max:%5u Avg:%5u Range:%5u StdDev:%u.%02u\r\n",
+                ms, usFrac, adc, ch, r->window, r->kind == LOG_WINDOW ? "avg  " : "test ", r->test,
+                r->min, r->max, r->avg, r->range, r->stdX100 / 100U, r->stdX100 % 100U);
+    UART_writeString(uartBuffer);
+}
+
+/* Report records lost to a lapped ring; returns the oldest one left */
+static uint32_t logOldest(uint32_t i)
+{
+    if(logHead - i > LOG_SIZE)
+    {
+        sprintf(uartBuffer, "  (%lu log records overwritten)\r\n",
+                (unsigned long)(logHead - LOG_SIZE - i));
+        UART_writeString(uartBuffer);
+        i = logHead - LOG_SIZE;
+    }
+    return i;
+}
+
+/* Print the records not printed yet, or everything still in the ring */
+void drainEventLog(bool all)
+{
+    uint32_t i = logOldest(all ? 0 : logDrained);
+
+    for(; i != logHead; i++)
+    {
+        const LogRecord* r = &eventLog[(uint16_t)i & (LOG_SIZE - 1U)];
+        if(logLevel[r->kind] <= logVerbosity) printLogRecord(r);
+    }
+    logDrained = logHead;
+}
+
+/* Background slice - format at most one pending record */
+void drainEventLogStep(void)
+{
+    uint32_t i;
+
+    if(!UART_lineFree()) return;
+    i = logOldest(logDrained);
+
+    while(i != logHead)
+    {
+        const LogRecord* r = &eventLog[(uint16_t)i & (LOG_SIZE - 1U)];
+        i++;
+        if(logLevel[r->kind] <= logVerbosity)
+        {
+            printLogRecord(r);
+            break;
+        }
+    }
+    logDrained = i;
+}
+
+/********************************************************************************
+ * Acquisition Window Setters
+ *******************************************************************************/
+void setAcquisitionWindowADC0(uint16_t cycles)
+{
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[0], 0, cycles);
+#else
+    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_EPWM1_SOCA, ADC_CH_ADCIN0, cycles);
+    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER1, ADC_TRIGGER_EPWM1_SOCB, ADC_CH_ADCIN2, cycles);
+    ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER2, ADC_TRIGGER_EPWM2_SOCA, ADC_CH_ADCIN4, cycles);
+    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER2);
+    ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER3);
+#endif
+    waitUs(100);
+}
 
 void setAcquisitionWindowADC1(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[1], 0, cycles);
+#else
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER3, ADC_TRIGGER_EPWM2_SOCB, ADC_CH_ADCIN0, cycles);
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER8, ADC_TRIGGER_EPWM5_SOCA, ADC_CH_ADCIN2, cycles);
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER9, ADC_TRIGGER_EPWM5_SOCB, ADC_CH_ADCIN4, cycles);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER3);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void setAcquisitionWindowADC2(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[2], 0, cycles);
+#else
     ADC_setupSOC(myADC2_BASE, ADC_SOC_NUMBER10, ADC_TRIGGER_EPWM6_SOCA, ADC_CH_ADCIN2, cycles);
     ADC_setupSOC(myADC2_BASE, ADC_SOC_NUMBER11, ADC_TRIGGER_EPWM6_SOCB, ADC_CH_ADCIN4, cycles);
     ADC_clearInterruptStatus(myADC2_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC2_BASE, ADC_INT_NUMBER2);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void setAcquisitionWindowADC3(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[3], 0, cycles);
+#else
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER4, ADC_TRIGGER_EPWM3_SOCA, ADC_CH_ADCIN0, cycles);
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER5, ADC_TRIGGER_EPWM3_SOCB, ADC_CH_ADCIN1, cycles);
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER6, ADC_TRIGGER_EPWM4_SOCA, ADC_CH_ADCIN2, cycles);
@@ -236,42 +1194,58 @@ void setAcquisitionWindowADC3(uint16_t cycles)
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER3);
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER4);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void ReconfigureandsetAcquisitionWindowADC0(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[0], 1, cycles);
+#else
     ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_EPWM1_SOCA, ADC_CH_ADCIN1, cycles);
     ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER1, ADC_TRIGGER_EPWM1_SOCB, ADC_CH_ADCIN3, cycles);
     ADC_setupSOC(myADC0_BASE, ADC_SOC_NUMBER2, ADC_TRIGGER_EPWM2_SOCA, ADC_CH_ADCIN5, cycles);
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC0_BASE, ADC_INT_NUMBER3);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void ReconfigureandsetAcquisitionWindowADC1(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[1], 1, cycles);
+#else
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER3, ADC_TRIGGER_EPWM2_SOCB, ADC_CH_ADCIN1, cycles);
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER8, ADC_TRIGGER_EPWM5_SOCA, ADC_CH_ADCIN3, cycles);
     ADC_setupSOC(myADC1_BASE, ADC_SOC_NUMBER9, ADC_TRIGGER_EPWM5_SOCB, ADC_CH_ADCIN5, cycles);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC1_BASE, ADC_INT_NUMBER3);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void ReconfigureandsetAcquisitionWindowADC2(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[2], 1, cycles);
+#else
     ADC_setupSOC(myADC2_BASE, ADC_SOC_NUMBER10, ADC_TRIGGER_EPWM6_SOCA, ADC_CH_ADCIN3, cycles);
     ADC_setupSOC(myADC2_BASE, ADC_SOC_NUMBER11, ADC_TRIGGER_EPWM6_SOCB, ADC_CH_ADCIN5, cycles);
     ADC_clearInterruptStatus(myADC2_BASE, ADC_INT_NUMBER1);
     ADC_clearInterruptStatus(myADC2_BASE, ADC_INT_NUMBER2);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 void ReconfigureandsetAcquisitionWindowADC3(uint16_t cycles)
 {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    setupOversampleSOCs(&adcPaths[3], 1, cycles);
+#else
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER4, ADC_TRIGGER_EPWM3_SOCA, ADC_CH_ADCIN4, cycles);
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER5, ADC_TRIGGER_EPWM3_SOCB, ADC_CH_ADCIN5, cycles);
     ADC_setupSOC(myADC3_BASE, ADC_SOC_NUMBER6, ADC_TRIGGER_EPWM4_SOCA, ADC_CH_ADCIN14, cycles);
@@ -280,457 +1254,2258 @@ void ReconfigureandsetAcquisitionWindowADC3(uint16_t cycles)
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER2);
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER3);
     ADC_clearInterruptStatus(myADC3_BASE, ADC_INT_NUMBER4);
-    DEVICE_DELAY_US(100);
+#endif
+    waitUs(100);
 }
 
 /********************************************************************************
  * ISRs - Using shared arrays
  *******************************************************************************/
-__interrupt void INT_myADC0_1_ISR(void)
+RAMFUNC __interrupt void INT_myADC0_1_ISR(void)
 {
-    ADC_ISR_BODY(0, myADC0_RESULT_BASE, ADC_SOC_NUMBER0,
+    ADC_ISR_BODY(0, 0, myADC0_RESULT_BASE, ADC_SOC_NUMBER0,
                  myADC0_BASE, ADC_INT_NUMBER1, INT_myADC0_1_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC0_2_ISR(void)
+RAMFUNC __interrupt void INT_myADC0_2_ISR(void)
 {
-    ADC_ISR_BODY(1, myADC0_RESULT_BASE, ADC_SOC_NUMBER1,
+    ADC_ISR_BODY(0, 1, myADC0_RESULT_BASE, ADC_SOC_NUMBER1,
                  myADC0_BASE, ADC_INT_NUMBER2, INT_myADC0_2_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC0_3_ISR(void)
+RAMFUNC __interrupt void INT_myADC0_3_ISR(void)
 {
-    ADC_ISR_BODY(2, myADC0_RESULT_BASE, ADC_SOC_NUMBER2,
+    ADC_ISR_BODY(0, 2, myADC0_RESULT_BASE, ADC_SOC_NUMBER2,
                  myADC0_BASE, ADC_INT_NUMBER3, INT_myADC0_3_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC1_1_ISR(void)
+RAMFUNC __interrupt void INT_myADC1_1_ISR(void)
 {
-    ADC_ISR_BODY(0, myADC1_RESULT_BASE, ADC_SOC_NUMBER3,
+    ADC_ISR_BODY(1, 0, myADC1_RESULT_BASE, ADC_SOC_NUMBER3,
                  myADC1_BASE, ADC_INT_NUMBER1, INT_myADC1_1_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC1_2_ISR(void)
+RAMFUNC __interrupt void INT_myADC1_2_ISR(void)
 {
-    ADC_ISR_BODY(1, myADC1_RESULT_BASE, ADC_SOC_NUMBER8,
+    ADC_ISR_BODY(1, 1, myADC1_RESULT_BASE, ADC_SOC_NUMBER8,
                  myADC1_BASE, ADC_INT_NUMBER2, INT_myADC1_2_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC1_3_ISR(void)
+RAMFUNC __interrupt void INT_myADC1_3_ISR(void)
 {
-    ADC_ISR_BODY(2, myADC1_RESULT_BASE, ADC_SOC_NUMBER9,
+    ADC_ISR_BODY(1, 2, myADC1_RESULT_BASE, ADC_SOC_NUMBER9,
                  myADC1_BASE, ADC_INT_NUMBER3, INT_myADC1_3_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC2_1_ISR(void)
+RAMFUNC __interrupt void INT_myADC2_1_ISR(void)
 {
-    ADC_ISR_BODY(0, myADC2_RESULT_BASE, ADC_SOC_NUMBER10,
+    ADC_ISR_BODY(2, 0, myADC2_RESULT_BASE, ADC_SOC_NUMBER10,
                  myADC2_BASE, ADC_INT_NUMBER1, INT_myADC2_1_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC2_2_ISR(void)
+RAMFUNC __interrupt void INT_myADC2_2_ISR(void)
 {
-    ADC_ISR_BODY(1, myADC2_RESULT_BASE, ADC_SOC_NUMBER11,
+    ADC_ISR_BODY(2, 1, myADC2_RESULT_BASE, ADC_SOC_NUMBER11,
                  myADC2_BASE, ADC_INT_NUMBER2, INT_myADC2_2_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC3_1_ISR(void)
+RAMFUNC __interrupt void INT_myADC3_1_ISR(void)
 {
-    ADC_ISR_BODY(0, myADC3_RESULT_BASE, ADC_SOC_NUMBER4,
+    ADC_ISR_BODY(3, 0, myADC3_RESULT_BASE, ADC_SOC_NUMBER4,
                  myADC3_BASE, ADC_INT_NUMBER1, INT_myADC3_1_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC3_2_ISR(void)
+RAMFUNC __interrupt void INT_myADC3_2_ISR(void)
 {
-    ADC_ISR_BODY(1, myADC3_RESULT_BASE, ADC_SOC_NUMBER5,
+    ADC_ISR_BODY(3, 1, myADC3_RESULT_BASE, ADC_SOC_NUMBER5,
                  myADC3_BASE, ADC_INT_NUMBER2, INT_myADC3_2_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC3_3_ISR(void)
+RAMFUNC __interrupt void INT_myADC3_3_ISR(void)
 {
-    ADC_ISR_BODY(2, myADC3_RESULT_BASE, ADC_SOC_NUMBER6,
+    ADC_ISR_BODY(3, 2, myADC3_RESULT_BASE, ADC_SOC_NUMBER6,
                  myADC3_BASE, ADC_INT_NUMBER3, INT_myADC3_3_INTERRUPT_ACK_GROUP)
 }
 
-__interrupt void INT_myADC3_4_ISR(void)
+RAMFUNC __interrupt void INT_myADC3_4_ISR(void)
 {
-    ADC_ISR_BODY(3, myADC3_RESULT_BASE, ADC_SOC_NUMBER7,
+    ADC_ISR_BODY(3, 3, myADC3_RESULT_BASE, ADC_SOC_NUMBER7,
                  myADC3_BASE, ADC_INT_NUMBER4, INT_myADC3_4_INTERRUPT_ACK_GROUP)
 }
 
 /********************************************************************************
- * Helper to reset shared arrays before each test
+ * ISRs - End-of-sequence mode
  *******************************************************************************/
-static void resetSharedArrays(uint16_t numChannels)
+RAMFUNC static inline void readAllResults(const AdcPath* p)
 {
     uint16_t ch;
-    for(ch = 0; ch < numChannels; ch++)
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    /* ch k owns SOCs k*N .. k*N+N-1 - sum in conversion order, decimate once */
+    uint16_t n;
+    uint16_t soc = 0;
+    for(ch = 0; ch < p->numCh; ch++)
     {
-        adcSampleCount[ch] = 0;
-        adcIndex[ch] = 0;
-        adcComplete[ch] = 0;
+        uint32_t sum = 0;
+        for(n = 0; n < OVERSAMPLE_FACTOR; n++, soc++)
+            sum += ADC_readResult(p->resultBase, (ADC_SOCNumber)soc);
+        adcResults[ch][adcIndex[ch]] = (uint16_t)((sum + OVERSAMPLE_FACTOR / 2) / OVERSAMPLE_FACTOR);
+        adcDropStats[p - adcPaths][ch].samples++;
+        ADC_RECORD_DELAY(p - adcPaths, ch, p->base)
+        adcIndex[ch]++;
+        adcSampleCount[ch]++;
+        if(adcIndex[ch] >= sweepCfg.samples) adcIndex[ch] = 0;
+    }
+#else
+    for(ch = 0; ch < p->numCh; ch++)
+    {
+        adcResults[ch][adcIndex[ch]] = ADC_readResult(p->resultBase, p->soc[ch]);
+        adcDropStats[p - adcPaths][ch].samples++;
+        ADC_RECORD_DELAY(p - adcPaths, ch, p->base)
+        adcIndex[ch]++;
+        adcSampleCount[ch]++;
+        if(adcIndex[ch] >= sweepCfg.samples) adcIndex[ch] = 0;
     }
+#endif
 }
 
-/********************************************************************************
- * Polling helper - simplified with shared arrays
- *******************************************************************************/
-static void pollChannel(uint32_t adcBase, ADC_SOCNumber socNum, 
-                       uint16_t ch, const char* errorMsg)
+/* SOCs forced per round - only the scheduled channels' (N per channel in
+ * oversample mode), so dropped pins cost no conversion time */
+static uint16_t roundMask[NUM_ADCS];
+
+RAMFUNC static inline uint16_t roundSocMask(const AdcPath* p)
 {
-    uint32_t timeout;
-    if(adcSampleCount[ch] < RESULTS_BUFFER_SIZE)
-    {
-        ADC_forceSOC(adcBase, socNum);
-        timeout = 0;
-        while(adcComplete[ch] == 0)
-        {
-            if(++timeout > 1000000)
-            {
-                UART_writeString(errorMsg);
-                while(1);
-            }
-        }
-        adcComplete[ch] = 0;
-    }
+    return roundMask[p - adcPaths];
 }
 
-/********************************************************************************
- * Test functions - Using shared arrays but storing to separate result arrays
- *******************************************************************************/
-void runSingleTestADC0(uint16_t testNumber)
+/* Set the forced SOCs for the channels in chMask and move ADCINT1 to the
+ * last of them - round-robin from SOC0 converts the highest one last */
+static void setRoundSchedule(uint16_t adc, uint16_t chMask)
 {
-    //UART_writeString(" [ADC0] Sampling IN0, IN2, IN4...");
-    
-    resetSharedArrays(ADC0_NUM_CH);
-    GPIO_writePin(myBoardLED0_GPIO, 0);
-    startPWM();
+    const AdcPath* p = &adcPaths[adc];
+    uint16_t mask = 0;
+    uint16_t last = 0;
+    uint16_t ch;
 
-    while(adcSampleCount[0] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[1] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[2] < RESULTS_BUFFER_SIZE)
+    for(ch = 0; ch < p->numCh; ch++)
     {
-        pollChannel(myADC0_BASE, ADC_SOC_NUMBER0, 0, "\r\nERROR: ADC0 ch0 timeout!\r\n");
-        pollChannel(myADC0_BASE, ADC_SOC_NUMBER1, 1, "\r\nERROR: ADC0 ch1 timeout!\r\n");
-        pollChannel(myADC0_BASE, ADC_SOC_NUMBER2, 2, "\r\nERROR: ADC0 ch2 timeout!\r\n");
-        DEVICE_DELAY_US(SAMPLE_DELAY_US);
+        if(!(chMask & (1U << ch))) continue;
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+        mask |= ((1U << OVERSAMPLE_FACTOR) - 1U) << (ch * OVERSAMPLE_FACTOR);
+        last = ch * OVERSAMPLE_FACTOR + OVERSAMPLE_FACTOR - 1U;
+#else
+        mask |= 1U << p->soc[ch];
+        if(p->soc[ch] > last) last = p->soc[ch];
+#endif
     }
-
-    GPIO_writePin(myBoardLED0_GPIO, 1);
-
-    // Copy from shared adcResults to ADC0-specific storage
-    calculateStatistics(adcResults[0], &adc0TestResults[0][testNumber]);
-    calculateStatistics(adcResults[1], &adc0TestResults[1][testNumber]);
-    calculateStatistics(adcResults[2], &adc0TestResults[2][testNumber]);
-
-    //displayTestResult(testNumber, "A0-IN0", &adc0TestResults[0][testNumber]);
-    //displayTestResult(testNumber, "A0-IN2", &adc0TestResults[1][testNumber]);
-    //displayTestResult(testNumber, "A0-IN4", &adc0TestResults[2][testNumber]);
+    roundMask[adc] = mask;
+    if(mask != 0U) ADC_setInterruptSource(p->base, ADC_INT_NUMBER1, (ADC_SOCNumber)last);
 }
 
-void runSingleTestADC1(uint16_t testNumber)
+/* A lost ADCINT1 loses the whole round - charge it to every channel. SOC
+ * overflow is charged to the channel owning the SOC. */
+RAMFUNC static inline void checkRoundOverflow(uint16_t adc)
 {
-    //UART_writeString(" [ADC1] Sampling IN0, IN2, IN4...");
-    
-    resetSharedArrays(ADC1_NUM_CH);
-    GPIO_writePin(myBoardLED0_GPIO, 0);
-    startPWM();
+    const AdcPath* p = &adcPaths[adc];
+    uint16_t ovf = ADC_SOC_OVF(p->base) & roundSocMask(p);
+    uint16_t ch;
 
-    while(adcSampleCount[0] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[1] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[2] < RESULTS_BUFFER_SIZE)
+    if(ovf != 0U)
+    {
+        for(ch = 0; ch < p->numCh; ch++)
+        {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+            uint16_t chMask = ((1U << OVERSAMPLE_FACTOR) - 1U) << (ch * OVERSAMPLE_FACTOR);
+#else
+            uint16_t chMask = 1U << p->soc[ch];
+#endif
+            if(ovf & chMask) adcDropStats[adc][ch].overflow++;
+        }
+        ADC_CLEAR_SOC_OVF(p->base, ovf);
+    }
+    if(ADC_getInterruptOverflowStatus(p->base, ADC_INT_NUMBER1))
     {
-        pollChannel(myADC1_BASE, ADC_SOC_NUMBER3, 0, "\r\nERROR: ADC1 ch0 timeout!\r\n");
-        pollChannel(myADC1_BASE, ADC_SOC_NUMBER8, 1, "\r\nERROR: ADC1 ch1 timeout!\r\n");
-        pollChannel(myADC1_BASE, ADC_SOC_NUMBER9, 2, "\r\nERROR: ADC1 ch2 timeout!\r\n");
-        DEVICE_DELAY_US(SAMPLE_DELAY_US);
+        for(ch = 0; ch < p->numCh; ch++) adcDropStats[adc][ch].late++;
+        ADC_clearInterruptOverflowStatus(p->base, ADC_INT_NUMBER1);
     }
+}
 
-    GPIO_writePin(myBoardLED0_GPIO, 1);
+RAMFUNC __interrupt void INT_myADC0_EOS_ISR(void)
+{
+    ADC_EOS_ISR_BODY(0)
+}
 
-    calculateStatistics(adcResults[0], &adc1TestResults[0][testNumber]);
-    calculateStatistics(adcResults[1], &adc1TestResults[1][testNumber]);
-    calculateStatistics(adcResults[2], &adc1TestResults[2][testNumber]);
+RAMFUNC __interrupt void INT_myADC1_EOS_ISR(void)
+{
+    ADC_EOS_ISR_BODY(1)
+}
 
-    //displayTestResult(testNumber, "A1-IN0", &adc1TestResults[0][testNumber]);
-    //displayTestResult(testNumber, "A1-IN2", &adc1TestResults[1][testNumber]);
-    //displayTestResult(testNumber, "A1-IN4", &adc1TestResults[2][testNumber]);
+RAMFUNC __interrupt void INT_myADC2_EOS_ISR(void)
+{
+    ADC_EOS_ISR_BODY(2)
 }
 
-void runSingleTestADC2(uint16_t testNumber)
+RAMFUNC __interrupt void INT_myADC3_EOS_ISR(void)
 {
-    //UART_writeString(" [ADC2] Sampling IN2, IN4...");
-    
-    resetSharedArrays(ADC2_NUM_CH);
-    GPIO_writePin(myBoardLED0_GPIO, 0);
-    startPWM();
+    ADC_EOS_ISR_BODY(3)
+}
+
+/********************************************************************************
+ * PPB limit events - ADCxEVT, PIE group 10. myADC0..3 are ADCA..D.
+ *******************************************************************************/
+static const uint32_t adcEvtInt[NUM_ADCS] = {
+    INT_ADCA_EVT, INT_ADCB_EVT, INT_ADCC_EVT, INT_ADCD_EVT
+};
+
+RAMFUNC static void handleLimitEvent(uint16_t adc)
+{
+    const AdcPath* p = &adcPaths[adc];
+    uint32_t now = CYCLE_NOW();
+    uint16_t tbctr = EPWM_getTimeBaseCounterValue(myEPWM0_BASE);
+    uint16_t down = (EPWM_getTimeBaseCounterDirection(myEPWM0_BASE) ==
+                     EPWM_TIME_BASE_STATUS_COUNT_DOWN) ? 0x8000U : 0U;
+    uint16_t ch, st, next;
 
-    while(adcSampleCount[0] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[1] < RESULTS_BUFFER_SIZE)
+    for(ch = 0; ch < p->numCh; ch++)
     {
-        pollChannel(myADC2_BASE, ADC_SOC_NUMBER10, 0, "\r\nERROR: ADC2 ch0 timeout!\r\n");
-        pollChannel(myADC2_BASE, ADC_SOC_NUMBER11, 1, "\r\nERROR: ADC2 ch1 timeout!\r\n");
-        DEVICE_DELAY_US(SAMPLE_DELAY_US);
-    }
+        ADC_PPBNumber ppb = (ADC_PPBNumber)ch;
+        st = ADC_getPPBEventStatus(p->base, ppb) & limitArmed[adc][ch];
+        if(st == 0U) continue;
 
-    GPIO_writePin(myBoardLED0_GPIO, 1);
+        if(st & ADC_EVT_TRIPHI) limitHiCount[adc][ch]++;
+        else                    limitLoCount[adc][ch]++;
+        if(limitLogCount < LIMIT_LOG_SIZE)
+        {
+            volatile LimitEvent* e = &limitLog[limitLogCount++];
+            e->cycle = now;
+            e->tbctr = tbctr;
+            e->adc = adc;
+            e->ch = ch;
+            e->flags = st | down;
+        }
 
-    calculateStatistics(adcResults[0], &adc2TestResults[0][testNumber]);
-    calculateStatistics(adcResults[1], &adc2TestResults[1][testNumber]);
+        /* Re-arm for the opposite crossing; drop any stale flag for it */
+        next = (st & ADC_EVT_TRIPHI) ? ADC_EVT_TRIPLO : ADC_EVT_TRIPHI;
+        ADC_disablePPBEventInterrupt(p->base, ppb, st);
+        ADC_clearPPBEventStatus(p->base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+        ADC_enablePPBEventInterrupt(p->base, ppb, next);
+        limitArmed[adc][ch] = next;
+    }
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP10);
+}
 
-    //displayTestResult(testNumber, "A2-IN2", &adc2TestResults[0][testNumber]);
-    //displayTestResult(testNumber, "A2-IN4", &adc2TestResults[1][testNumber]);
+RAMFUNC __interrupt void INT_myADC0_EVT_ISR(void) { handleLimitEvent(0); }
+RAMFUNC __interrupt void INT_myADC1_EVT_ISR(void) { handleLimitEvent(1); }
+RAMFUNC __interrupt void INT_myADC2_EVT_ISR(void) { handleLimitEvent(2); }
+RAMFUNC __interrupt void INT_myADC3_EVT_ISR(void) { handleLimitEvent(3); }
+
+void resetLimitLog(void)
+{
+    uint16_t a, ch;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        for(ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            limitHiCount[a][ch] = 0;
+            limitLoCount[a][ch] = 0;
+        }
+    }
+    limitLogCount = 0;
 }
 
-void runSingleTestADC3(uint16_t testNumber)
+/* Uses the PPBs set up by configurePPBDelay - one per tested channel */
+void configureLimitMonitor(void)
 {
-    //UART_writeString(" [ADC3] Sampling IN0, IN1, IN2, IN3...");
-    
-    resetSharedArrays(ADC3_NUM_CH);
-    GPIO_writePin(myBoardLED0_GPIO, 0);
-    startPWM();
+    static void (* const evtIsr[NUM_ADCS])(void) = {
+        &INT_myADC0_EVT_ISR, &INT_myADC1_EVT_ISR,
+        &INT_myADC2_EVT_ISR, &INT_myADC3_EVT_ISR
+    };
+    uint16_t a, ch;
 
-    while(adcSampleCount[0] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[1] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[2] < RESULTS_BUFFER_SIZE ||
-          adcSampleCount[3] < RESULTS_BUFFER_SIZE)
+    for(a = 0; a < NUM_ADCS; a++)
     {
-        pollChannel(myADC3_BASE, ADC_SOC_NUMBER4, 0, "\r\nERROR: ADC3 ch0 timeout!\r\n");
-        pollChannel(myADC3_BASE, ADC_SOC_NUMBER5, 1, "\r\nERROR: ADC3 ch1 timeout!\r\n");
-        pollChannel(myADC3_BASE, ADC_SOC_NUMBER6, 2, "\r\nERROR: ADC3 ch2 timeout!\r\n");
-        pollChannel(myADC3_BASE, ADC_SOC_NUMBER7, 3, "\r\nERROR: ADC3 ch3 timeout!\r\n");
-        DEVICE_DELAY_US(SAMPLE_DELAY_US);
+        const AdcPath* p = &adcPaths[a];
+        for(ch = 0; ch < p->numCh; ch++)
+        {
+            ADC_PPBNumber ppb = (ADC_PPBNumber)ch;
+#if !PPB_DELAY_MONITOR
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+            ADC_setupPPB(p->base, ppb, (ADC_SOCNumber)(ch * OVERSAMPLE_FACTOR));
+#else
+            ADC_setupPPB(p->base, ppb, p->soc[ch]);
+#endif
+#endif
+            ADC_setPPBTripLimits(p->base, ppb, (int32_t)LIMIT_HI_COUNTS << adcResShift,
+                                 (int32_t)LIMIT_LO_COUNTS << adcResShift);
+            ADC_enablePPBEvent(p->base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+            ADC_clearPPBEventStatus(p->base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+            ADC_enablePPBEventInterrupt(p->base, ppb, ADC_EVT_TRIPHI);
+            limitArmed[a][ch] = ADC_EVT_TRIPHI;
+        }
+        Interrupt_register(adcEvtInt[a], evtIsr[a]);
+        Interrupt_enable(adcEvtInt[a]);
     }
+    resetLimitLog();
+}
 
-    GPIO_writePin(myBoardLED0_GPIO, 1);
+void displayLimitLog(void)
+{
+    uint16_t a, ch, i;
 
-    calculateStatistics(adcResults[0], &adc3TestResults[0][testNumber]);
-    calculateStatistics(adcResults[1], &adc3TestResults[1][testNumber]);
-    calculateStatistics(adcResults[2], &adc3TestResults[2][testNumber]);
-    calculateStatistics(adcResults[3], &adc3TestResults[3][testNumber]);
+    sprintf(uartBuffer, "  Limit crossings (hi %u / lo %u): ",
+            (uint16_t)(LIMIT_HI_COUNTS << adcResShift), (uint16_t)(LIMIT_LO_COUNTS << adcResShift));
+    UART_writeString(uartBuffer);
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            if(limitHiCount[a][ch] == 0U && limitLoCount[a][ch] == 0U) continue;
+            sprintf(uartBuffer, " A%u.%u:%u/%u", a, ch,
+                    limitHiCount[a][ch], limitLoCount[a][ch]);
+            UART_writeString(uartBuffer);
+        }
+    }
+    UART_writeString("\r\n");
 
-    //displayTestResult(testNumber, "A3-IN0", &adc3TestResults[0][testNumber]);
-    //displayTestResult(testNumber, "A3-IN1", &adc3TestResults[1][testNumber]);
-    //displayTestResult(testNumber, "A3-IN2", &adc3TestResults[2][testNumber]);
-    //displayTestResult(testNumber, "A3-IN3", &adc3TestResults[3][testNumber]);
+    for(i = 0; i < limitLogCount && i < LIMIT_PRINT_EVENTS; i++)
+    {
+        volatile LimitEvent* e = &limitLog[i];
+        sprintf(uartBuffer, "    ADC%u ch%u %s  tbctr %5u %s  +%lu cycles\r\n",
+                e->adc, e->ch, (e->flags & ADC_EVT_TRIPHI) ? "HI" : "LO",
+                e->tbctr, (e->flags & 0x8000U) ? "dn" : "up",
+                (unsigned long)(limitLog[0].cycle - e->cycle));
+        UART_writeString(uartBuffer);
+    }
 }
 
 /********************************************************************************
- * Window Average Calculators
+ * Scope capture
  *******************************************************************************/
-static void averageChannel(WindowStats testArr[][TESTS_PER_WINDOW],
-                           uint16_t ch,
-                           WindowStats winArr[][NUM_WINDOWS],
-                           uint16_t winIdx)
-{
-    uint16_t j;
-    uint32_t sumMin = 0, sumMax = 0, sumAvg = 0, sumRange = 0;
-    float sumStd = 0.0f;
+/* ADC registers borrowed by the scope / coherent capture path */
+typedef struct {
+    uint32_t socCtl;
+    uint32_t intSocSel;
+    uint16_t intSel;
+} ScopeSave;
 
-    for(j = 0; j < TESTS_PER_WINDOW; j++)
-    {
-        sumMin += testArr[ch][j].min;
-        sumMax += testArr[ch][j].max;
-        sumAvg += testArr[ch][j].avg;
-        sumRange += testArr[ch][j].range;
-        sumStd += testArr[ch][j].stdDev;
-    }
-    winArr[ch][winIdx].windowCycles = ACQ_WINDOW_START + winIdx;
-    winArr[ch][winIdx].min = (uint16_t)(sumMin / TESTS_PER_WINDOW);
-    winArr[ch][winIdx].max = (uint16_t)(sumMax / TESTS_PER_WINDOW);
-    winArr[ch][winIdx].avg = (uint16_t)(sumAvg / TESTS_PER_WINDOW);
-    winArr[ch][winIdx].range = (uint16_t)(sumRange / TESTS_PER_WINDOW);
-    winArr[ch][winIdx].stdDev = sumStd / TESTS_PER_WINDOW;
-}
+static const DMA_Trigger scopeDmaTrig[NUM_ADCS] = {
+    DMA_TRIGGER_ADCA1, DMA_TRIGGER_ADCB1, DMA_TRIGGER_ADCC1, DMA_TRIGGER_ADCD1
+};
 
-void calculateWindowAverageADC0(uint16_t windowIndex)
+static inline uint16_t scopeWriteIndex(void)
 {
-    uint16_t ch;
-    for(ch = 0; ch < ADC0_NUM_CH; ch++)
-        averageChannel(adc0TestResults, ch, adc0WindowResults, windowIndex);
+    return (uint16_t)(HWREG(SCOPE_DMA_BASE + DMA_O_DST_ADDR_ACTIVE) - (uint32_t)scopeBuffer);
 }
 
-void calculateWindowAverageADC1(uint16_t windowIndex)
+static inline uint16_t scopeDistance(uint16_t from, uint16_t to)
 {
-    uint16_t ch;
-    for(ch = 0; ch < ADC1_NUM_CH; ch++)
-        averageChannel(adc1TestResults, ch, adc1WindowResults, windowIndex);
+    return (to >= from) ? (to - from) : (to + SCOPE_DEPTH - from);
 }
 
-void calculateWindowAverageADC2(uint16_t windowIndex)
+static inline bool scopeTimedOut(uint32_t t0)
 {
-    uint16_t ch;
-    for(ch = 0; ch < ADC2_NUM_CH; ch++)
-        averageChannel(adc2TestResults, ch, adc2WindowResults, windowIndex);
+    return (t0 - CYCLE_NOW()) > (uint32_t)SCOPE_TIMEOUT_MS * (DEVICE_SYSCLK_FREQ / 1000U);
 }
 
-void calculateWindowAverageADC3(uint16_t windowIndex)
+/* Wait for the PPB flag; false on timeout */
+static bool scopeWaitEvent(uint32_t base, uint16_t evt, uint32_t t0)
 {
-    uint16_t ch;
-    for(ch = 0; ch < ADC3_NUM_CH; ch++)
-        averageChannel(adc3TestResults, ch, adc3WindowResults, windowIndex);
+    while((ADC_getPPBEventStatus(base, SCOPE_PPB) & evt) == 0U)
+        if(scopeTimedOut(t0)) return false;
+    return true;
 }
 
-/********************************************************************************
- * Final Table Display
- *******************************************************************************/
-void displayFinalTableADC0(void)
+/* Take SCOPE_SOC for a back-to-back capture: its EOC raises ADCINT1, which
+ * both retriggers the SOC and requests one DMA word. The sweep's ePWM SOC
+ * triggers are masked so no tested SOC cuts into the sample train. */
+static void borrowScopeSOC(uint16_t adc, ScopeSave* save, ADC_Channel pin, ADC_Trigger trig)
 {
-    uint16_t w;
-    printTableHeader("ADC0", "ADCIN0 (SOC0)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc0WindowResults[0][w]);
-    printTableHeader("ADC0", "ADCIN2 (SOC1)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc0WindowResults[1][w]);
-    printTableHeader("ADC0", "ADCIN4 (SOC2)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc0WindowResults[2][w]);
+    const AdcPath* p = &adcPaths[adc];
+
+    save->socCtl = HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC);
+    save->intSocSel = HWREG(p->base + ADC_O_INTSOCSEL2);
+    save->intSel = HWREGH(p->base + ADC_O_INTSEL1N2);
+
+    Interrupt_disable(p->pieInt);
+#if LIMIT_MONITOR
+    Interrupt_disable(adcEvtInt[adc]);
+#endif
+    setSweepADCTriggers(false);
+
+    ADC_setupSOC(p->base, SCOPE_SOC, trig, pin, SCOPE_ACQ_CYCLES);
+    ADC_setInterruptSource(p->base, ADC_INT_NUMBER1, SCOPE_SOC);
+    ADC_enableContinuousMode(p->base, ADC_INT_NUMBER1);
+
+    DMA_initController();
+    DMA_setEmulationMode(DMA_EMULATION_FREE_RUN);
+    DMA_configAddresses(SCOPE_DMA_BASE, scopeBuffer,
+                        (const void*)(p->resultBase + ADC_O_RESULT0 + SCOPE_SOC));
+    DMA_configBurst(SCOPE_DMA_BASE, 1, 0, 0);
 }
 
-void displayFinalTableADC1(void)
+static void returnScopeSOC(uint16_t adc, const ScopeSave* save)
 {
-    uint16_t w;
-    printTableHeader("ADC1", "ADCIN0 (SOC3)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc1WindowResults[0][w]);
-    printTableHeader("ADC1", "ADCIN2 (SOC8)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc1WindowResults[1][w]);
-    printTableHeader("ADC1", "ADCIN4 (SOC9)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc1WindowResults[2][w]);
+    const AdcPath* p = &adcPaths[adc];
+
+    DMA_stopChannel(SCOPE_DMA_BASE);
+    ADC_setInterruptSOCTrigger(p->base, SCOPE_SOC, ADC_INT_SOC_TRIGGER_NONE);
+    ADC_disableContinuousMode(p->base, ADC_INT_NUMBER1);
+    stopEPWMs();
+    waitUs(10);
+    EALLOW;
+    HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC) = save->socCtl;
+    HWREG(p->base + ADC_O_INTSOCSEL2) = save->intSocSel;
+    HWREGH(p->base + ADC_O_INTSEL1N2) = save->intSel;
+    EDIS;
+    setSweepADCTriggers(true);
+    ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+    ADC_clearInterruptOverflowStatus(p->base, ADC_INT_NUMBER1);
+#if PPB_DELAY_MONITOR
+    configurePPBDelay();
+#endif
+#if LIMIT_MONITOR
+    configureLimitMonitor();
+#endif
+    Interrupt_clearACKGroup(p->ackGroup);
+    Interrupt_enable(p->pieInt);
 }
 
-void displayFinalTableADC2(void)
+bool runScopeCapture(uint16_t adc, ADC_Channel pin)
 {
-    uint16_t w;
-    printTableHeader("ADC2", "ADCIN2 (SOC10)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc2WindowResults[0][w]);
-    printTableHeader("ADC2", "ADCIN4 (SOC11)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc2WindowResults[1][w]);
+    const AdcPath* p = &adcPaths[adc];
+    ScopeSave save;
+    uint32_t t0;
+    uint16_t trig, i;
+    bool ok = false;
+
+    scopeAdc = adc;
+    borrowScopeSOC(adc, &save, pin, ADC_TRIGGER_SW_ONLY);
+    ADC_setInterruptSOCTrigger(p->base, SCOPE_SOC, ADC_INT_SOC_TRIGGER_ADCINT1);
+    ADC_setupPPB(p->base, SCOPE_PPB, SCOPE_SOC);
+    ADC_setPPBTripLimits(p->base, SCOPE_PPB, SCOPE_TRIG_LEVEL,
+                         SCOPE_TRIG_LEVEL - SCOPE_TRIG_HYST);
+    ADC_disablePPBEventInterrupt(p->base, SCOPE_PPB, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+    ADC_enablePPBEvent(p->base, SCOPE_PPB, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+
+    DMA_configTransfer(SCOPE_DMA_BASE, SCOPE_DEPTH, 0, 1);
+    DMA_configMode(SCOPE_DMA_BASE, scopeDmaTrig[adc], DMA_CFG_ONESHOT_DISABLE |
+                   DMA_CFG_CONTINUOUS_ENABLE | DMA_CFG_SIZE_16BIT);
+    DMA_enableTrigger(SCOPE_DMA_BASE);
+    DMA_startChannel(SCOPE_DMA_BASE);
+
+    startPWM();
+    ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+    t0 = CYCLE_NOW();
+    ADC_forceSOC(p->base, SCOPE_SOC);
+
+    /* Pre-trigger fill - also gives the real sample rate */
+    while(scopeWriteIndex() < SCOPE_PRE)
+        if(scopeTimedOut(t0)) goto restore;
+    scopeRateKsps = (uint32_t)((uint64_t)SCOPE_PRE * (DEVICE_SYSCLK_FREQ / 1000U) /
+                               (t0 - CYCLE_NOW()));
+
+    /* Rising edge: signal must be seen low first, then cross the level */
+    ADC_clearPPBEventStatus(p->base, SCOPE_PPB, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+    if(!scopeWaitEvent(p->base, ADC_EVT_TRIPLO, t0)) goto restore;
+    ADC_clearPPBEventStatus(p->base, SCOPE_PPB, ADC_EVT_TRIPHI);
+    if(!scopeWaitEvent(p->base, ADC_EVT_TRIPHI, t0)) goto restore;
+    trig = scopeWriteIndex();
+
+    while(scopeDistance(trig, scopeWriteIndex()) < SCOPE_POST)
+        if(scopeTimedOut(t0)) goto restore;
+    DMA_stopChannel(SCOPE_DMA_BASE);
+
+    /* Detection is polled - walk back to the first sample at/above the level */
+    trig = (trig + SCOPE_DEPTH - 1U) % SCOPE_DEPTH;
+    for(i = 0; i < 64U; i++)
+    {
+        uint16_t prev = (trig + SCOPE_DEPTH - 1U) % SCOPE_DEPTH;
+        if(scopeBuffer[prev] < SCOPE_TRIG_LEVEL) break;
+        trig = prev;
+    }
+    scopeTrigIndex = trig;
+    ok = true;
+
+restore:
+    ADC_disablePPBEvent(p->base, SCOPE_PPB, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+    ADC_clearPPBEventStatus(p->base, SCOPE_PPB, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
+    returnScopeSOC(adc, &save);
+    return ok;
 }
 
-void displayFinalTableADC3(void)
+/* SCOPE_PRE + SCOPE_POST samples around the trigger as CSV: offset,counts */
+void displayScopeCapture(void)
 {
-    uint16_t w;
-    printTableHeader("ADC3", "ADCIN0 (SOC4)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc3WindowResults[0][w]);
-    printTableHeader("ADC3", "ADCIN1 (SOC5)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc3WindowResults[1][w]);
-    printTableHeader("ADC3", "ADCIN2 (SOC6)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc3WindowResults[2][w]);
-    printTableHeader("ADC3", "ADCIN3 (SOC7)");
-    for(w = 0; w < NUM_WINDOWS; w++) printTableRow(ACQ_WINDOW_START + w, &adc3WindowResults[3][w]);
+    int16_t k;
+    uint16_t idx;
+
+    sprintf(uartBuffer, "\r\n=== Scope ADC%u: %lu kSPS, trigger %u, pre %u, post %u ===\r\n",
+            scopeAdc, (unsigned long)scopeRateKsps, (uint16_t)SCOPE_TRIG_LEVEL,
+            (uint16_t)SCOPE_PRE, (uint16_t)SCOPE_POST);
+    UART_writeString(uartBuffer);
+    UART_writeString("sample,counts\r\n");
+    for(k = -(int16_t)SCOPE_PRE; k < (int16_t)SCOPE_POST; k++)
+    {
+        idx = (uint16_t)(((int32_t)scopeTrigIndex + k + SCOPE_DEPTH) % SCOPE_DEPTH);
+        sprintf(uartBuffer, "%d,%u\r\n", k, scopeBuffer[idx]);
+        UART_writeString(uartBuffer);
+    }
 }
 
 /********************************************************************************
- * main - MAINTAINS ORIGINAL INTERLEAVED TEST FLOW
+ * Coherent averaging - the first conversion of every shot is started by the
+ * same ePWM compare event, so bin k is the same instant relative to the PWM
+ * edge in every repetition and the shots can be summed sample-by-sample.
  *******************************************************************************/
-void main(void)
-{
-    uint16_t i, j;
-    uint16_t currentWindow;
-
-    Device_init();
-    Device_initGPIO();
-    Interrupt_initModule();
-    Interrupt_initVectorTable();
-    Board_init();
+/* ePWM8 SOCA setup lent to the coherent average */
+typedef struct {
+    uint16_t cmpc;
+    uint16_t etsel;
+    uint16_t etps;
+    uint16_t etsocps;
+} TrigSave;
 
-    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+static void borrowCohTrigger(TrigSave* save)
+{
+    save->cmpc = EPWM_getCounterCompareValue(COH_TRIG_EPWM, EPWM_COUNTER_COMPARE_C);
+    save->etsel = HWREGH(COH_TRIG_EPWM + EPWM_O_ETSEL);     /* no driverlib getters */
+    save->etps = HWREGH(COH_TRIG_EPWM + EPWM_O_ETPS);
+    save->etsocps = HWREGH(COH_TRIG_EPWM + EPWM_O_ETSOCPS);
+}
 
-    EINT;
-    ERTM;
+static void returnCohTrigger(const TrigSave* save)
+{
+    EPWM_setCounterCompareValue(COH_TRIG_EPWM, EPWM_COUNTER_COMPARE_C, save->cmpc);
+    HWREGH(COH_TRIG_EPWM + EPWM_O_ETSOCPS) = save->etsocps;
+    HWREGH(COH_TRIG_EPWM + EPWM_O_ETPS) = save->etps;
+    HWREGH(COH_TRIG_EPWM + EPWM_O_ETSEL) = save->etsel;
+    EPWM_clearADCTriggerFlag(COH_TRIG_EPWM, EPWM_SOC_A);
+}
 
-    delayMs(500);
+static bool coherentShot(uint16_t adc)
+{
+    const AdcPath* p = &adcPaths[adc];
+    uint32_t t0 = CYCLE_NOW();
+    bool done = true;
 
-    UART_writeString("Press ANY KEY to start Phase 1 ADC sweep test...\r\n\r\n");
-    waitForKeyPress();
-    UART_writeString("Starting sweep: ADC0(3ch) + ADC1(3ch) + ADC2(2ch) + ADC3(4ch)\r\n");
-    UART_writeString("========================================================\r\n");
+    DMA_configAddresses(SCOPE_DMA_BASE, scopeBuffer,
+                        (const void*)(p->resultBase + ADC_O_RESULT0 + SCOPE_SOC));
+    DMA_startChannel(SCOPE_DMA_BASE);
+    ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+    ADC_setInterruptSOCTrigger(p->base, SCOPE_SOC, ADC_INT_SOC_TRIGGER_ADCINT1);
+    EPWM_clearADCTriggerFlag(COH_TRIG_EPWM, EPWM_SOC_A);
+    EPWM_enableADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
 
-    /* PHASE 1 - Original interleaved pattern maintained */
-    for(i = 0; i < NUM_WINDOWS; i++)
+    /* Channel halts by itself once COH_BINS words have moved */
+    while(HWREGH(SCOPE_DMA_BASE + DMA_O_CONTROL) & DMA_CONTROL_RUNSTS)
     {
-        currentWindow = ACQ_WINDOW_START + i;
-        sprintf(uartBuffer, "\r\n=== Window %2u cycles (%uns) ===\r\n",
-                currentWindow, currentWindow * 5);
-        UART_writeString(uartBuffer);
+        if(scopeTimedOut(t0))
+        {
+            DMA_stopChannel(SCOPE_DMA_BASE);
+            done = false;
+            break;
+        }
+    }
+    EPWM_disableADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
+    ADC_setInterruptSOCTrigger(p->base, SCOPE_SOC, ADC_INT_SOC_TRIGGER_NONE);
+    waitUs(2);              /* let the last retriggered conversion drain */
 
-        stopEPWMs();
-        delayMs(5);
+    return done;
+}
 
-        setAcquisitionWindowADC0(currentWindow);
-        setAcquisitionWindowADC1(currentWindow);
-        setAcquisitionWindowADC2(currentWindow);
-        setAcquisitionWindowADC3(currentWindow);
-        delayMs(10);
+bool runCoherentAverage(uint16_t adc, uint16_t phase, uint16_t reps)
+{
+    const AdcPath* p = &adcPaths[adc];
+    uint16_t cmpa = EPWM_getCounterCompareValue(myEPWM0_BASE, EPWM_COUNTER_COMPARE_A);
+    ScopeSave save;
+    TrigSave trig;
+    uint16_t ch, r, k;
+    bool ok = true;
 
-        for(j = 0; j < TESTS_PER_WINDOW; j++)
-        {
-            runSingleTestADC0(j);  // Uses shared arrays, stores to adc0TestResults
-            delayMs(20);
+    cohAdc = adc;
+    cohReps = reps;
+    cohNumCh = 0;       /* Counts only channels whose reps all completed */
 
-            runSingleTestADC1(j);  // Uses shared arrays, stores to adc1TestResults
-            delayMs(20);
+    /* Trigger point: COH_PRE_TBCLK ahead of the up-count CMPA edge. An
+     * earlier CMPA would wrap CMPC past TBPRD and no shot would start. */
+    if(cmpa < COH_PRE_TBCLK)
+    {
+        sprintf(uartBuffer, "Coherent: EPWM1 CMPA %u < %u TBCLK pre-trigger\r\n",
+                cmpa, (uint16_t)COH_PRE_TBCLK);
+        UART_writeString(uartBuffer);
+        return false;
+    }
+    borrowCohTrigger(&trig);
+    EPWM_setCounterCompareValue(COH_TRIG_EPWM, EPWM_COUNTER_COMPARE_C, cmpa - COH_PRE_TBCLK);
+    EPWM_setADCTriggerSource(COH_TRIG_EPWM, EPWM_SOC_A, EPWM_SOC_TBCTR_U_CMPC);
+    EPWM_setADCTriggerEventPrescale(COH_TRIG_EPWM, EPWM_SOC_A, 1);
+    EPWM_disableADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
 
-            runSingleTestADC2(j);  // Uses shared arrays, stores to adc2TestResults
-            delayMs(20);
+    for(ch = 0; ch < p->numCh && ok; ch++)
+    {
+        borrowScopeSOC(adc, &save, p->phaseCh[phase][ch], COH_ADC_TRIGGER);
+        DMA_configTransfer(SCOPE_DMA_BASE, COH_BINS, 0, 1);
+        DMA_configMode(SCOPE_DMA_BASE, scopeDmaTrig[adc], DMA_CFG_ONESHOT_DISABLE |
+                       DMA_CFG_CONTINUOUS_DISABLE | DMA_CFG_SIZE_16BIT);
+        DMA_enableTrigger(SCOPE_DMA_BASE);
+        startPWM();
 
-            runSingleTestADC3(j);  // Uses shared arrays, stores to adc3TestResults
-            delayMs(20);
+        for(k = 0; k < COH_BINS; k++) cohSum[k] = 0;
+        for(r = 0; r < reps; r++)
+        {
+            if(!coherentShot(adc)) { ok = false; break; }
+            for(k = 0; k < COH_BINS; k++) cohSum[k] += scopeBuffer[k];
         }
+        returnScopeSOC(adc, &save);
+        if(!ok) break;      /* A partial sum is dropped, not averaged */
 
-        calculateWindowAverageADC0(i);
-        calculateWindowAverageADC1(i);
-        calculateWindowAverageADC2(i);
-        calculateWindowAverageADC3(i);
-
-        delayMs(100);
+        /* Average kept with COH_FRAC_BITS of sub-LSB resolution */
+        for(k = 0; k < COH_BINS; k++)
+            cohWave[ch][k] = (uint16_t)((((uint64_t)cohSum[k] << COH_FRAC_BITS) + reps / 2U) / reps);
+        cohNumCh = ch + 1U;
     }
+    returnCohTrigger(&trig);
+    return ok;
+}
 
-    stopEPWMs();
+/* Averaged waveforms as CSV: bin, then one column per channel in LSB */
+void displayCoherentAverage(void)
+{
+    uint16_t k, ch;
+    char* s;
 
-    UART_writeString("\r\n\r\n========================================================\r\n");
-    UART_writeString("               PHASE 1 FINAL RESULTS                    \r\n");
-    UART_writeString("========================================================\r\n");
+    sprintf(uartBuffer, "\r\n=== Coherent average ADC%u: %u shots, %u bins, edge at bin ~%u ===\r\n",
+            cohAdc, cohReps, (uint16_t)COH_BINS,
+            (uint16_t)((uint32_t)COH_PRE_TBCLK * (scopeRateKsps ? scopeRateKsps : COH_EST_KSPS)
+                       / (DEVICE_SYSCLK_FREQ / 4000U)));
+    UART_writeString(uartBuffer);
+    for(k = 0; k < COH_BINS; k++)
+    {
+        s = uartBuffer + sprintf(uartBuffer, "%u", k);
+        for(ch = 0; ch < cohNumCh; ch++)
+            s += sprintf(s, ",%u.%04u", cohWave[ch][k] >> COH_FRAC_BITS,
+                         (uint16_t)((uint32_t)(cohWave[ch][k] & ((1U << COH_FRAC_BITS) - 1U))
+                                    * 10000U >> COH_FRAC_BITS));
+        sprintf(s, "\r\n");
+        UART_writeString(uartBuffer);
+    }
+}
+
+/********************************************************************************
+ * Open/short pre-pass
+ *******************************************************************************/
+static const char* const chanStateName[] = { "connected", "OPEN", "SHORTED" };
+
+/* OS_SAMPLES software conversions of pin on SCOPE_SOC with the given O/S mode */
+static void sampleOpenShort(uint32_t base, uint32_t resultBase, ADC_Channel pin,
+                            ADC_OSDetectMode mode, uint16_t* avg, uint16_t* range)
+{
+    uint16_t n, v, lo = 0xFFFFU, hi = 0;
+    uint32_t sum = 0;
+
+    ADC_setupSOC(base, SCOPE_SOC, ADC_TRIGGER_SW_ONLY, pin, OS_ACQ_CYCLES);
+    ADC_configOSDetectMode(base, mode);
+    waitUs(OS_SAMPLE_SPACING_US);
+    for(n = 0; n < OS_SAMPLES; n++)
+    {
+        ADC_forceSOC(base, SCOPE_SOC);
+        waitUs(OS_SAMPLE_SPACING_US);               /* >> one conversion */
+        v = ADC_readResult(resultBase, SCOPE_SOC);
+        sum += v;
+        if(v < lo) lo = v;
+        if(v > hi) hi = v;
+    }
+    ADC_configOSDetectMode(base, ADC_OSDETECT_MODE_DISABLED);
+    *avg = (uint16_t)((sum + OS_SAMPLES / 2) / OS_SAMPLES);
+    *range = hi - lo;
+}
+
+/* Runs with the PWMs toggling (the stimulus) but their ADC triggers masked,
+ * so only SCOPE_SOC converts; SCOPE_SOC's own setup is restored afterwards */
+void detectOpenShort(void)
+{
+    uint16_t phase, a, ch;
+    uint16_t avg, range, avgDown, avgUp, dummy;
+
+    UART_writeString("\r\nOpen/short pre-pass (plain / 5K pull-down / 5K pull-up):\r\n");
+    setSweepADCTriggers(false);
+    startPWM();
+    for(phase = 0; phase < NUM_PHASES; phase++)
+    {
+        for(a = 0; a < NUM_ADCS; a++)
+        {
+            const AdcPath* p = &adcPaths[a];
+            uint32_t socCtl = HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC);
+
+            chanActive[phase][a] = 0;
+            for(ch = 0; ch < p->numCh; ch++)
+            {
+                ADC_Channel pin = p->phaseCh[phase][ch];
+                ChannelState st = CH_CONNECTED;
+
+                sampleOpenShort(p->base, p->resultBase, pin, ADC_OSDETECT_MODE_DISABLED, &avg, &range);
+                sampleOpenShort(p->base, p->resultBase, pin, ADC_OSDETECT_MODE_5K_PULLDOWN_TO_VSSA,
+                                &avgDown, &dummy);
+                sampleOpenShort(p->base, p->resultBase, pin, ADC_OSDETECT_MODE_5K_PULLUP_TO_VDDA,
+                                &avgUp, &dummy);
+
+                if(avgUp > avgDown && (avgUp - avgDown) > OS_PULL_DELTA)
+                    st = CH_OPEN;
+                else if(range <= OS_STUCK_RANGE &&
+                        (avg <= OS_RAIL_COUNTS || avg >= 4095U - OS_RAIL_COUNTS))
+                    st = CH_SHORTED;
+
+                chanState[phase][a][ch] = st;
+                if(st == CH_CONNECTED) chanActive[phase][a] |= (1U << ch);
+
+                sprintf(uartBuffer, "  P%u ADC%u ADCIN%-2u avg %4u range %4u pd %4u pu %4u  %s\r\n",
+                        phase + 1, a, (uint16_t)pin, avg, range, avgDown, avgUp,
+                        chanStateName[st]);
+                UART_writeString(uartBuffer);
+            }
+
+            EALLOW;
+            HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC) = socCtl;
+            EDIS;
+        }
+    }
+    stopEPWMs();
+    setSweepADCTriggers(true);
+
+    for(phase = 0; phase < NUM_PHASES; phase++)
+        for(a = 0; a < NUM_ADCS; a++)
+            for(ch = 0; ch < adcPaths[a].numCh; ch++)
+                if(!(chanActive[phase][a] & (1U << ch)))
+                {
+                    sprintf(uartBuffer, "WARNING: Phase %u ADC%u ADCIN%u %s - dropped from the sweep\r\n",
+                            phase + 1, a, (uint16_t)adcPaths[a].phaseCh[phase][ch],
+                            chanStateName[chanState[phase][a][ch]]);
+                    UART_writeString(uartBuffer);
+                }
+}
+
+/********************************************************************************
+ * Channel-order scan - every (predecessor, measured) pair of one ADC's
+ * scheduled pins at every sweep window, then the SOC order and the
+ * dummy-conversion option that settle at the shortest window
+ *******************************************************************************/
+int16_t orderErr[NUM_WINDOWS][MAX_CHANNELS + 1][MAX_CHANNELS];
+static uint16_t orderAdc, orderPhase, orderNumWin;
+static uint16_t orderMask;
+
+/* Mean of ORDER_SAMPLES conversions of meas right after prev, LSB x 100 */
+static int32_t orderPairMean(const AdcPath* p, ADC_Channel prev, ADC_Channel meas, uint16_t cycles)
+{
+    uint16_t n;
+    uint32_t sum = 0;
+
+    ADC_setupSOC(p->base, ORDER_PREV_SOC, ADC_TRIGGER_SW_ONLY, prev, cycles);
+    ADC_setupSOC(p->base, ORDER_MEAS_SOC, ADC_TRIGGER_SW_ONLY, meas, cycles);
+    for(n = 0; n < ORDER_SAMPLES; n++)
+    {
+        /* Rewriting SOCPRICTL resets the round-robin pointer - SOC14 first */
+        ADC_setSOCPriority(p->base, ADC_PRI_ALL_ROUND_ROBIN);
+        ADC_forceMultipleSOC(p->base, (1U << ORDER_PREV_SOC) | (1U << ORDER_MEAS_SOC));
+        waitUs(ORDER_SPACING_US);
+        sum += ADC_readResult(p->resultBase, ORDER_MEAS_SOC);
+    }
+    return (int32_t)((sum * 100UL + ORDER_SAMPLES / 2) / ORDER_SAMPLES);
+}
+
+void runOrderScan(uint16_t adc, uint16_t phase)
+{
+    const AdcPath* p = &adcPaths[adc];
+    uint32_t save14 = HWREG(p->base + ADC_O_SOC0CTL + 2U * ORDER_PREV_SOC);
+    uint32_t save15 = HWREG(p->base + ADC_O_SOC0CTL + 2U * ORDER_MEAS_SOC);
+    uint16_t w, k, m;
+
+    orderAdc = adc;
+    orderPhase = phase;
+    sweepPhase = phase;
+    orderMask = scheduledMask(adc);
+    orderNumWin = sweepNumWindows();
+
+    stopEPWMs();
+    setSweepADCTriggers(false);
+    Interrupt_disable(p->pieInt);
+
+    for(w = 0; w < orderNumWin; w++)
+        for(m = 0; m < p->numCh; m++)
+        {
+            int32_t ref, e;
+            if(!(orderMask & (1U << m))) continue;
+            ref = orderPairMean(p, p->phaseCh[phase][m], p->phaseCh[phase][m], windowCycles(w));
+            for(k = 0; k <= MAX_CHANNELS; k++)
+            {
+                if(k < MAX_CHANNELS && (k == m || !(orderMask & (1U << k)))) continue;
+                e = orderPairMean(p, (k == ORDER_DUMMY) ? ORDER_DUMMY_PIN : p->phaseCh[phase][k],
+                                  p->phaseCh[phase][m], windowCycles(w)) - ref;
+                if(e > 32767L) e = 32767L;
+                if(e < -32767L) e = -32767L;
+                orderErr[w][k][m] = (int16_t)e;
+            }
+            orderErr[w][m][m] = 0;
+        }
+
+    EALLOW;
+    HWREG(p->base + ADC_O_SOC0CTL + 2U * ORDER_PREV_SOC) = save14;
+    HWREG(p->base + ADC_O_SOC0CTL + 2U * ORDER_MEAS_SOC) = save15;
+    EDIS;
+    setSweepADCTriggers(true);
+    ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+    ADC_clearInterruptOverflowStatus(p->base, ADC_INT_NUMBER1);
+    Interrupt_clearACKGroup(p->ackGroup);
+    Interrupt_enable(p->pieInt);
+}
+
+static uint16_t orderAbs(int16_t e)
+{
+    return (e < 0) ? (uint16_t)(-e) : (uint16_t)e;
+}
+
+/* Worst |error| of a cyclic SOC order - the last pin precedes the first
+ * pin of the next round */
+static uint16_t orderCost(const uint16_t* ord, uint16_t n, uint16_t w)
+{
+    uint16_t i, e, worst = 0;
+    for(i = 0; i < n; i++)
+    {
+        e = orderAbs(orderErr[w][ord[(i + n - 1U) % n]][ord[i]]);
+        if(e > worst) worst = e;
+    }
+    return worst;
+}
+
+/* Best cyclic order of the n scheduled channels in ch[] at window w */
+static uint16_t orderBest(const uint16_t* ch, uint16_t n, uint16_t w, uint16_t* best)
+{
+    uint16_t code, total = 1, i, used, cost;
+    uint16_t bestCost = 0xFFFFU;
+    uint16_t ord[MAX_CHANNELS];
+
+    for(i = 0; i < n; i++) total *= n;
+    for(code = 0; code < total; code++)
+    {
+        uint16_t c = code;
+        used = 0;
+        for(i = 0; i < n; i++, c /= n)
+        {
+            ord[i] = ch[c % n];
+            used |= 1U << (c % n);
+        }
+        if(used != (1U << n) - 1U) continue;
+        cost = orderCost(ord, n, w);
+        if(cost < bestCost)
+        {
+            bestCost = cost;
+            for(i = 0; i < n; i++) best[i] = ord[i];
+        }
+    }
+    return bestCost;
+}
+
+static void printOrder(const uint16_t* ord, uint16_t n)
+{
+    uint16_t i;
+    for(i = 0; i < n; i++)
+    {
+        sprintf(uartBuffer, "%sIN%u", i ? ">" : "",
+                (uint16_t)adcPaths[orderAdc].phaseCh[orderPhase][ord[i]]);
+        UART_writeString(uartBuffer);
+    }
+}
+
+static void printSettledWindow(uint16_t w)
+{
+    if(w == 0xFFFFU)
+    {
+        UART_writeString("not within the window range\r\n");
+        return;
+    }
+    sprintf(uartBuffer, "%u cycles\r\n", windowCycles(w));
+    UART_writeString(uartBuffer);
+}
+
+void displayOrderScan(void)
+{
+    const AdcPath* p = &adcPaths[orderAdc];
+    uint16_t ch[MAX_CHANNELS], best[MAX_CHANNELS];
+    uint16_t w, k, m, n = 0, e;
+    uint16_t winDefault = 0xFFFFU, winBest = 0xFFFFU, winDummy = 0xFFFFU;
+
+    UART_writeString("adc,cycles,prev,pin,err_lsb\r\n");
+    for(w = 0; w < orderNumWin; w++)
+        for(m = 0; m < p->numCh; m++)
+            for(k = 0; k <= MAX_CHANNELS; k++)
+            {
+                int16_t v = orderErr[w][k][m];
+                if(!(orderMask & (1U << m)) || k == m) continue;
+                if(k < MAX_CHANNELS && !(orderMask & (1U << k))) continue;
+                sprintf(uartBuffer, "%u,%u,%s%u,%u,%s%u.%02u\r\n", orderAdc, windowCycles(w),
+                        (k == ORDER_DUMMY) ? "dummy" : "", (uint16_t)((k == ORDER_DUMMY) ? ORDER_DUMMY_PIN
+                                                                   : p->phaseCh[orderPhase][k]),
+                        (uint16_t)p->phaseCh[orderPhase][m],
+                        v < 0 ? "-" : "", orderAbs(v) / 100U, orderAbs(v) % 100U);
+                UART_writeString(uartBuffer);
+            }
+
+    for(m = 0; m < p->numCh; m++)
+        if(orderMask & (1U << m)) ch[n++] = m;
+    if(n < 2U)
+    {
+        UART_writeString("Fewer than two scheduled pins - no order to choose\r\n");
+        return;
+    }
+
+    /* Shortest settled window for SOC order, best order and dummy-first */
+    for(w = 0; w < orderNumWin; w++)
+    {
+        uint16_t dummyWorst = 0;
+        if(winDefault == 0xFFFFU && orderCost(ch, n, w) <= ORDER_ERR_TOL_X100) winDefault = w;
+        if(winBest == 0xFFFFU && orderBest(ch, n, w, best) <= ORDER_ERR_TOL_X100) winBest = w;
+        for(m = 0; m < n; m++)
+        {
+            e = orderAbs(orderErr[w][ORDER_DUMMY][ch[m]]);
+            if(e > dummyWorst) dummyWorst = e;
+        }
+        if(winDummy == 0xFFFFU && dummyWorst <= ORDER_ERR_TOL_X100) winDummy = w;
+    }
+
+    sprintf(uartBuffer, "ADC%u settled (|err| <= %u.%02u LSB):\r\n  SOC order    ", orderAdc,
+            (uint16_t)ORDER_ERR_TOL_X100 / 100U, (uint16_t)ORDER_ERR_TOL_X100 % 100U);
+    UART_writeString(uartBuffer);
+    printOrder(ch, n);
+    UART_writeString(" : ");
+    printSettledWindow(winDefault);
+
+    UART_writeString("  best order   ");
+    if(winBest != 0xFFFFU)
+    {
+        orderBest(ch, n, winBest, best);
+        printOrder(best, n);
+        UART_writeString(" : ");
+    }
+    printSettledWindow(winBest);
+
+    sprintf(uartBuffer, "  dummy IN%u before each pin (half rate) : ", (uint16_t)ORDER_DUMMY_PIN);
+    UART_writeString(uartBuffer);
+    printSettledWindow(winDummy);
+}
+
+/********************************************************************************
+ * Crosstalk matrix - one forced ePWM8 SOCA starts SCOPE_SOC on all four ADCs
+ * together, so every round is a simultaneous sample of one pin per ADC.
+ * SCOPE_PPB stamps each ADC's trigger-to-sample delay, which gives the skew
+ * between converters. The aggressor DAC alternates low/high between rounds
+ * while the other DACs stay low; a victim's crosstalk is its high-minus-low
+ * mean.
+ *******************************************************************************/
+int16_t xtalkErr[NUM_WINDOWS][XTALK_NUM_AGGR][NUM_ADCS][MAX_CHANNELS];
+DelayStats xtalkDelay[NUM_ADCS];
+static uint16_t xtalkPhase, xtalkNumWin;
+
+/* DACA/B/C output pins - ADCINA0, ADCINA1, ADCINB1 */
+static const uint16_t stimAdc[XTALK_NUM_AGGR] = { 0, 0, 1 };
+static const ADC_Channel stimPin[XTALK_NUM_AGGR] = { ADC_CH_ADCIN0, ADC_CH_ADCIN1, ADC_CH_ADCIN1 };
+
+static void setStimulusLevel(uint16_t aggr, uint16_t code)
+{
+    uint16_t d;
+    for(d = 0; d < XTALK_NUM_AGGR; d++)
+        if(STIM_DAC_MASK & (1U << d))
+            DAC_setShadowValue(stimDacBases[d], (d == aggr) ? code : STIM_LO_CODE);
+}
+
+/* XTALK_ROUNDS simultaneous rounds of victim set ch - ADCs with fewer
+ * channels convert their last pin so all four stay busy */
+static void xtalkRounds(uint16_t w, uint16_t aggr, uint16_t ch)
+{
+    uint32_t sum[NUM_ADCS][2];
+    uint16_t a, n, hi;
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+        uint16_t c = (ch < p->numCh) ? ch : p->numCh - 1U;
+        ADC_setupSOC(p->base, SCOPE_SOC, COH_ADC_TRIGGER, p->phaseCh[xtalkPhase][c], windowCycles(w));
+        sum[a][0] = 0;
+        sum[a][1] = 0;
+    }
+
+    for(n = 0; n < XTALK_ROUNDS; n++)
+    {
+        hi = n & 1U;
+        setStimulusLevel(aggr, hi ? STIM_HI_CODE : STIM_LO_CODE);
+        DEVICE_DELAY_US(XTALK_EDGE_US);     /* Timed step, not a settling wait - no yield */
+        EPWM_forceADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
+        waitUs(XTALK_SPACING_US);
+        for(a = 0; a < NUM_ADCS; a++)
+        {
+            sum[a][hi] += ADC_readResult(adcPaths[a].resultBase, SCOPE_SOC);
+            recordDelay(&xtalkDelay[a], ADC_getPPBDelayTimeStamp(adcPaths[a].base, SCOPE_PPB));
+        }
+    }
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        int32_t e = ((int32_t)sum[a][1] - (int32_t)sum[a][0]) * 100L / (XTALK_ROUNDS / 2);
+        if(ch >= adcPaths[a].numCh) continue;
+        if(e > 32767L) e = 32767L;
+        if(e < -32767L) e = -32767L;
+        xtalkErr[w][aggr][a][ch] = (int16_t)e;
+    }
+}
+
+void runCrosstalk(uint16_t phase)
+{
+    uint32_t socCtl[NUM_ADCS];
+    uint16_t a, w, d, ch;
+
+    xtalkPhase = phase;
+    xtalkNumWin = sweepNumWindows();
+    stopEPWMs();
+    setSweepADCTriggers(false);
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+        socCtl[a] = HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC);
+        Interrupt_disable(p->pieInt);
+#if LIMIT_MONITOR
+        Interrupt_disable(adcEvtInt[a]);
+#endif
+        ADC_setupPPB(p->base, SCOPE_PPB, SCOPE_SOC);
+        xtalkDelay[a].min = 0xFFFFU;
+        xtalkDelay[a].max = 0;
+        xtalkDelay[a].sum = 0;
+        xtalkDelay[a].count = 0;
+        for(d = 0; d < DELAY_HIST_BINS; d++) xtalkDelay[a].bin[d] = 0;
+    }
+    for(d = 0; d < XTALK_NUM_AGGR; d++)
+        if(STIM_DAC_MASK & (1U << d)) DAC_setLoadMode(stimDacBases[d], DAC_LOAD_SYSCLK);
+
+    /* The ePWM8 counter is stopped, so only the force produces a SOCA */
+    EPWM_setADCTriggerSource(COH_TRIG_EPWM, EPWM_SOC_A, EPWM_SOC_TBCTR_PERIOD);
+    EPWM_setADCTriggerEventPrescale(COH_TRIG_EPWM, EPWM_SOC_A, 1);
+    EPWM_enableADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
+
+    for(w = 0; w < xtalkNumWin; w++)
+        for(d = 0; d < XTALK_NUM_AGGR; d++)
+        {
+            if(!(STIM_DAC_MASK & (1U << d))) continue;
+            for(ch = 0; ch < MAX_CHANNELS; ch++) xtalkRounds(w, d, ch);
+        }
+
+    EPWM_disableADCTrigger(COH_TRIG_EPWM, EPWM_SOC_A);
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+        EALLOW;
+        HWREG(p->base + ADC_O_SOC0CTL + 2U * SCOPE_SOC) = socCtl[a];
+        EDIS;
+        ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+        ADC_clearInterruptOverflowStatus(p->base, ADC_INT_NUMBER1);
+        Interrupt_clearACKGroup(p->ackGroup);
+        Interrupt_enable(p->pieInt);
+    }
+    setSweepADCTriggers(true);
+#if PPB_DELAY_MONITOR
+    configurePPBDelay();
+#endif
+#if LIMIT_MONITOR
+    configureLimitMonitor();
+#endif
+    resetStimulus();
+}
+
+void displayCrosstalk(void)
+{
+    uint16_t w, d, a, ch;
+
+    UART_writeString("cycles,aggressor,adc,pin,self,dev_lsb\r\n");
+    for(w = 0; w < xtalkNumWin; w++)
+        for(d = 0; d < XTALK_NUM_AGGR; d++)
+        {
+            if(!(STIM_DAC_MASK & (1U << d))) continue;
+            for(a = 0; a < NUM_ADCS; a++)
+                for(ch = 0; ch < adcPaths[a].numCh; ch++)
+                {
+                    int16_t v = xtalkErr[w][d][a][ch];
+                    uint16_t m = (v < 0) ? (uint16_t)(-v) : (uint16_t)v;
+                    ADC_Channel pin = adcPaths[a].phaseCh[xtalkPhase][ch];
+                    sprintf(uartBuffer, "%u,DAC%c,%u,%u,%u,%s%u.%02u\r\n", windowCycles(w),
+                            (char)('A' + d), a, (uint16_t)pin,
+                            (uint16_t)(a == stimAdc[d] && pin == stimPin[d]),
+                            v < 0 ? "-" : "", m / 100U, m % 100U);
+                    UART_writeString(uartBuffer);
+                }
+        }
+
+    UART_writeString("Simultaneous trigger -> sample delay [cyc] min/avg/max, skew vs ADC0\r\n");
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        DelayStats* s = &xtalkDelay[a];
+        uint16_t avg = s->count ? (uint16_t)(s->sum / s->count) : 0;
+        uint16_t avg0 = xtalkDelay[0].count ? (uint16_t)(xtalkDelay[0].sum / xtalkDelay[0].count) : 0;
+        sprintf(uartBuffer, "  ADC%u %4u %4u %4u  %+d\r\n", a, s->count ? s->min : 0, avg, s->max,
+                (int)avg - (int)avg0);
+        UART_writeString(uartBuffer);
+    }
+}
+
+/********************************************************************************
+ * End-of-sequence mode setup
+ *
+ * ADCINT1 of each ADC is moved to the highest scheduled SOC and the
+ * remaining per-SOC interrupts are disabled. One software force then
+ * converts the scheduled SOCs back-to-back in round-robin order and a
+ * single ISR entry collects the whole round.
+ *******************************************************************************/
+void configureEosMode(void)
+{
+    static void (* const eosIsr[NUM_ADCS])(void) = {
+        &INT_myADC0_EOS_ISR, &INT_myADC1_EOS_ISR,
+        &INT_myADC2_EOS_ISR, &INT_myADC3_EOS_ISR
+    };
+    uint16_t a;
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+
+        ADC_disableInterrupt(p->base, ADC_INT_NUMBER2);
+        ADC_disableInterrupt(p->base, ADC_INT_NUMBER3);
+        ADC_disableInterrupt(p->base, ADC_INT_NUMBER4);
+        setRoundSchedule(a, 0xFFFFU);   /* Narrowed per test by resetSharedArrays */
+        ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+
+        Interrupt_register(p->pieInt, eosIsr[a]);
+    }
+    setSweepADCTriggers(false);
+}
+
+/********************************************************************************
+ * Interrupt pulse position - end of S+H window in early-interrupt mode
+ *******************************************************************************/
+void configureInterruptPulse(void)
+{
+    uint16_t a;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+#if ADC_EARLY_INT
+        ADC_setInterruptPulseMode(adcPaths[a].base, ADC_PULSE_END_OF_ACQ_WIN);
+#else
+        ADC_setInterruptPulseMode(adcPaths[a].base, ADC_PULSE_END_OF_CONV);
+#endif
+    }
+}
+
+/********************************************************************************
+ * Converter setup - clock divider, resolution and signal mode of all four
+ * ADCs. The converters are powered down around the change; ADC_setMode
+ * reloads the INL and offset trims for the new resolution.
+ *******************************************************************************/
+/* Conversion time in SYSCLK cycles - ADCCLK divider is (prescale + 2) / 2 */
+static uint16_t adcConvCycles(uint16_t prescale, uint16_t resolution)
+{
+    uint16_t convX4 = (resolution == ADC_RESOLUTION_16BIT) ? ADC_CONV_X4_16BIT : ADC_CONV_X4_12BIT;
+    return (uint16_t)(((uint32_t)convX4 * (prescale + 2U) + 7U) / 8U);
+}
+
+void configureConverters(ADC_ClkPrescale prescale, ADC_Resolution resolution, ADC_SignalMode mode)
+{
+    uint16_t a, ch, ph;
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+        ADC_disableConverter(p->base);
+        ADC_setPrescaler(p->base, prescale);
+        ADC_setMode(p->base, resolution, mode);
+        ADC_enableConverter(p->base);
+
+        /* Differential pairs are ADCINn/n+1 with n even */
+        for(ph = 0; ph < NUM_PHASES; ph++)
+        {
+            diffPinMask[ph][a] = 0;
+            for(ch = 0; ch < p->numCh; ch++)
+                if(((uint16_t)p->phaseCh[ph][ch] & 1U) == 0) diffPinMask[ph][a] |= 1U << ch;
+        }
+    }
+    adcSignalMode = mode;
+    adcResShift = (resolution == ADC_RESOLUTION_16BIT) ? 4U : 0U;
+    adcEarlyIntOffset = adcConvCycles(prescale, resolution) + ADC_LATCH_SYSCLK - ISR_ENTRY_CYCLES;
+    waitUs(1000);               /* ADC power-up */
+#if LIMIT_MONITOR
+    configureLimitMonitor();
+#endif
+}
+
+/********************************************************************************
+ * PPB delay stamps - one PPB per tested channel, on the SOC whose trigger
+ * starts that channel's conversion (first of N when oversampling)
+ *******************************************************************************/
+void configurePPBDelay(void)
+{
+    uint16_t a, ch;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        const AdcPath* p = &adcPaths[a];
+        for(ch = 0; ch < p->numCh; ch++)
+        {
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+            ADC_setupPPB(p->base, (ADC_PPBNumber)ch, (ADC_SOCNumber)(ch * OVERSAMPLE_FACTOR));
+#else
+            ADC_setupPPB(p->base, (ADC_PPBNumber)ch, p->soc[ch]);
+#endif
+        }
+    }
+}
+
+void resetDelayStats(void)
+{
+    uint16_t a, ch, b;
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        for(ch = 0; ch < MAX_CHANNELS; ch++)
+        {
+            adcDelayStats[a][ch].min = 0xFFFF;
+            adcDelayStats[a][ch].max = 0;
+            adcDelayStats[a][ch].sum = 0;
+            adcDelayStats[a][ch].count = 0;
+            for(b = 0; b < DELAY_HIST_BINS; b++) adcDelayStats[a][ch].bin[b] = 0;
+        }
+    }
+}
+
+void displayDelayStats(void)
+{
+    uint16_t a, ch, b;
+    sprintf(uartBuffer, "  Trigger->conv delay (cycles)  min  avg  max | bins of %u\r\n",
+            (uint16_t)DELAY_BIN_CYCLES);
+    UART_writeString(uartBuffer);
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            volatile DelayStats* d = &adcDelayStats[a][ch];
+            sprintf(uartBuffer, "  ADC%u ch%u %4u %4lu %4u |", a, ch,
+                    d->count ? d->min : 0,
+                    (unsigned long)(d->count ? d->sum / d->count : 0), d->max);
+            UART_writeString(uartBuffer);
+            for(b = 0; b < DELAY_HIST_BINS; b++)
+            {
+                sprintf(uartBuffer, " %4u", d->bin[b]);
+                UART_writeString(uartBuffer);
+            }
+            UART_writeString("\r\n");
+        }
+    }
+}
+
+/********************************************************************************
+ * Oversampling setup
+ *
+ * Reprograms SOC0..SOC(numCh*N-1) so each tested pin is converted N times
+ * back-to-back from one software force. Burst mode is left disabled: a burst
+ * walks the round-robin pointer over all 16 SOCs, so bursts shorter than 16
+ * would drift across the sequence from one trigger to the next.
+ *******************************************************************************/
+void setupOversampleSOCs(const AdcPath* p, uint16_t phase, uint16_t cycles)
+{
+    uint16_t ch, n;
+    uint16_t soc = 0;
+
+    for(ch = 0; ch < p->numCh; ch++)
+        for(n = 0; n < OVERSAMPLE_FACTOR; n++, soc++)
+            ADC_setupSOC(p->base, (ADC_SOCNumber)soc, ADC_TRIGGER_SW_ONLY,
+                         p->phaseCh[phase][ch], cycles);
+
+    ADC_clearInterruptStatus(p->base, ADC_INT_NUMBER1);
+    waitUs(100);
+}
+
+/********************************************************************************
+ * Helper to reset shared arrays before each test
+ *******************************************************************************/
+static void resetSharedArrays(uint16_t adc)
+{
+    uint16_t ch;
+
+    adcRate[adc].armed = false;     /* No gap across the pause between tests */
+    /* DEVICE_DELAY_US's count: (us * SYSCLK MHz - 9 call cycles) / 5 per loop */
+    samplePauseLoops = (sweepCfg.delayUs == 0U) ? 0UL :
+        ((uint32_t)sweepCfg.delayUs * (DEVICE_SYSCLK_FREQ / 1000000UL) - 9UL) / 5UL;
+    for(ch = 0; ch < adcPaths[adc].numCh; ch++)
+    {
+        adcSampleCount[ch] = 0;
+        adcIndex[ch] = 0;
+        adcComplete[ch] = 0;
+#if ACQ_MODE == ACQ_MODE_PER_SOC
+        /* Dropped channel starts "full" so its SOC is never forced */
+        if(!(scheduledMask(adc) & (1U << ch))) adcSampleCount[ch] = sweepCfg.samples;
+#endif
+    }
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    setRoundSchedule(adc, scheduledMask(adc));
+#endif
+}
+
+/********************************************************************************
+ * Polling helper - simplified with shared arrays
+ *******************************************************************************/
+RAMFUNC static bool pollChannel(uint16_t adc, uint32_t adcBase, ADC_SOCNumber socNum,
+                               uint16_t ch, const char* errorMsg)
+{
+    uint32_t timeout;
+    uint32_t t0;
+    if(adcSampleCount[ch] < sweepCfg.samples)
+    {
+        t0 = CYCLE_NOW();
+        ADC_forceSOC(adcBase, socNum);
+        timeout = 0;
+        while(adcComplete[ch] == 0)
+        {
+            if(++timeout > 1000000)
+            {
+                adcDropStats[adc][ch].timeout++;
+                UART_writeString(errorMsg);
+                return false;
+            }
+        }
+        recordLatency(&turnaroundLatency[adc], t0 - CYCLE_NOW());
+        recordLatency(&isrEntryLatency[adc], t0 - isrEntryStamp);
+        adcComplete[ch] = 0;
+    }
+    return true;
+}
+
+/********************************************************************************
+ * End-of-sequence acquisition - one forced round per ADC per loop
+ *******************************************************************************/
+RAMFUNC static bool acquireEOS(uint16_t adc, const char* errorMsg)
+{
+    const AdcPath* p = &adcPaths[adc];
+    uint32_t timeout;
+    uint32_t t0;
+
+    /* Rewriting SOCPRICTL resets the round-robin pointer so the round
+     * always starts from the lowest scheduled SOC and ends on ADCINT1's */
+    ADC_setSOCPriority(p->base, ADC_PRI_ALL_ROUND_ROBIN);
+
+    while(adcSampleCount[0] < sweepCfg.samples)
+    {
+        adcComplete[0] = 0;
+        t0 = CYCLE_NOW();
+        ADC_forceMultipleSOC(p->base, roundSocMask(p));
+        timeout = 0;
+        while(adcComplete[0] == 0)
+        {
+            if(++timeout > TIMEOUT_CYCLES)
+            {
+                uint16_t ch;
+                for(ch = 0; ch < p->numCh; ch++) adcDropStats[adc][ch].timeout++;
+                UART_writeString(errorMsg);
+                return false;
+            }
+        }
+        recordLatency(&turnaroundLatency[adc], t0 - CYCLE_NOW());
+        recordLatency(&isrEntryLatency[adc], t0 - isrEntryStamp);
+        SAMPLE_PAUSE();
+    }
+    adcComplete[0] = 0;
+    return true;
+}
+
+/********************************************************************************
+ * Timeout recovery - drop any half-finished round so a retry starts clean
+ *******************************************************************************/
+static void recoverADC(uint16_t adc)
+{
+    uint32_t base = adcPaths[adc].base;
+
+    stopEPWMs();
+    ADC_clearInterruptStatus(base, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(base, ADC_INT_NUMBER2);
+    ADC_clearInterruptStatus(base, ADC_INT_NUMBER3);
+    ADC_clearInterruptStatus(base, ADC_INT_NUMBER4);
+    ADC_clearInterruptOverflowStatus(base, ADC_INT_NUMBER1);
+    ADC_clearInterruptOverflowStatus(base, ADC_INT_NUMBER2);
+    ADC_clearInterruptOverflowStatus(base, ADC_INT_NUMBER3);
+    ADC_clearInterruptOverflowStatus(base, ADC_INT_NUMBER4);
+    ADC_CLEAR_SOC_OVF(base, 0xFFFFU);
+    Interrupt_clearACKGroup(adcPaths[adc].ackGroup);
+    delayMs(1);
+}
+
+static void markTestInvalid(uint16_t adc, uint16_t testNumber)
+{
+    uint16_t ch;
+    for(ch = 0; ch < adcPaths[adc].numCh; ch++) setTestValid(RES_ROW(adc, ch), testNumber, false);
+}
+
+/* Statistics of shared buffer ch into the store */
+static void storeTest(uint16_t adc, uint16_t ch, uint16_t testNumber)
+{
+    WindowStats s;
+    calculateStatistics(adcResults[ch], &s);
+    storeTestResult(RES_ROW(adc, ch), testNumber, &s);
+}
+
+/* Run one test, retrying after a timeout; false once all attempts failed
+ * (the runner has then already marked the test invalid) */
+static bool runTestWithRetry(bool (*runTest)(uint16_t), uint16_t adc, uint16_t testNumber)
+{
+    uint16_t attempt;
+
+    for(attempt = 0; attempt <= TEST_MAX_RETRIES; attempt++)
+    {
+        if(runTest(testNumber)) return true;
+        recoverADC(adc);
+#if EVENT_LOG
+        logStats(LOG_RETRY, adc, attempt, logWindow, testNumber, NULL);
+#else
+        sprintf(uartBuffer, "  ADC%u test %u attempt %u/%u failed\r\n",
+                adc, testNumber, attempt + 1, (uint16_t)(TEST_MAX_RETRIES + 1));
+        UART_writeString(uartBuffer);
+#endif
+    }
+    return false;
+}
+
+/* Run one ADC's test if the pre-pass and the shell's mask left it any
+ * channel; dropped channels are recorded as invalid so they never enter the
+ * window averages */
+static void runScheduledTest(bool (*runTest)(uint16_t), uint16_t adc, uint16_t testNumber)
+{
+    uint16_t ch;
+
+    if(scheduledMask(adc) != 0)
+    {
+#if EVENT_LOG
+        WindowStats s;
+        if(runTestWithRetry(runTest, adc, testNumber))
+            for(ch = 0; ch < adcPaths[adc].numCh; ch++)
+                if(scheduledMask(adc) & (1U << ch))
+                {
+                    loadTestResult(RES_ROW(adc, ch), testNumber, &s);
+                    logStats(LOG_TEST, adc, ch, logWindow, testNumber, &s);
+                }
+#else
+        runTestWithRetry(runTest, adc, testNumber);
+#endif
+        delayMs(20);
+    }
+    for(ch = 0; ch < adcPaths[adc].numCh; ch++)
+        if(!(scheduledMask(adc) & (1U << ch))) setTestValid(RES_ROW(adc, ch), testNumber, false);
+}
+
+/********************************************************************************
+ * Test functions - Using shared arrays but storing to separate result arrays
+ *******************************************************************************/
+bool runSingleTestADC0(uint16_t testNumber)
+{
+    bool ok = true;
+
+    //UART_writeString(" [ADC0] Sampling IN0, IN2, IN4...");
+    
+    resetSharedArrays(0);
+    GPIO_writePin(myBoardLED0_GPIO, 0);
+    startPWM();
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    ok = acquireEOS(0, "\r\nERROR: ADC0 EOS timeout!\r\n");
+#else
+    while(ok && (adcSampleCount[0] < sweepCfg.samples ||
+                 adcSampleCount[1] < sweepCfg.samples ||
+                 adcSampleCount[2] < sweepCfg.samples))
+    {
+        ok = ok && pollChannel(0, myADC0_BASE, ADC_SOC_NUMBER0, 0, "\r\nERROR: ADC0 ch0 timeout!\r\n");
+        ok = ok && pollChannel(0, myADC0_BASE, ADC_SOC_NUMBER1, 1, "\r\nERROR: ADC0 ch1 timeout!\r\n");
+        ok = ok && pollChannel(0, myADC0_BASE, ADC_SOC_NUMBER2, 2, "\r\nERROR: ADC0 ch2 timeout!\r\n");
+        SAMPLE_PAUSE();
+    }
+#endif
+
+    GPIO_writePin(myBoardLED0_GPIO, 1);
+
+    if(!ok)
+    {
+        markTestInvalid(0, testNumber);
+        return false;
+    }
+
+    // Copy from shared adcResults to ADC0-specific storage
+    storeTest(0, 0, testNumber);
+    storeTest(0, 1, testNumber);
+    storeTest(0, 2, testNumber);
+
+    return true;
+}
+
+bool runSingleTestADC1(uint16_t testNumber)
+{
+    bool ok = true;
+
+    //UART_writeString(" [ADC1] Sampling IN0, IN2, IN4...");
+    
+    resetSharedArrays(1);
+    GPIO_writePin(myBoardLED0_GPIO, 0);
+    startPWM();
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    ok = acquireEOS(1, "\r\nERROR: ADC1 EOS timeout!\r\n");
+#else
+    while(ok && (adcSampleCount[0] < sweepCfg.samples ||
+                 adcSampleCount[1] < sweepCfg.samples ||
+                 adcSampleCount[2] < sweepCfg.samples))
+    {
+        ok = ok && pollChannel(1, myADC1_BASE, ADC_SOC_NUMBER3, 0, "\r\nERROR: ADC1 ch0 timeout!\r\n");
+        ok = ok && pollChannel(1, myADC1_BASE, ADC_SOC_NUMBER8, 1, "\r\nERROR: ADC1 ch1 timeout!\r\n");
+        ok = ok && pollChannel(1, myADC1_BASE, ADC_SOC_NUMBER9, 2, "\r\nERROR: ADC1 ch2 timeout!\r\n");
+        SAMPLE_PAUSE();
+    }
+#endif
+
+    GPIO_writePin(myBoardLED0_GPIO, 1);
+
+    if(!ok)
+    {
+        markTestInvalid(1, testNumber);
+        return false;
+    }
+
+    storeTest(1, 0, testNumber);
+    storeTest(1, 1, testNumber);
+    storeTest(1, 2, testNumber);
+
+    return true;
+}
+
+bool runSingleTestADC2(uint16_t testNumber)
+{
+    bool ok = true;
+
+    //UART_writeString(" [ADC2] Sampling IN2, IN4...");
+    
+    resetSharedArrays(2);
+    GPIO_writePin(myBoardLED0_GPIO, 0);
+    startPWM();
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    ok = acquireEOS(2, "\r\nERROR: ADC2 EOS timeout!\r\n");
+#else
+    while(ok && (adcSampleCount[0] < sweepCfg.samples ||
+                 adcSampleCount[1] < sweepCfg.samples))
+    {
+        ok = ok && pollChannel(2, myADC2_BASE, ADC_SOC_NUMBER10, 0, "\r\nERROR: ADC2 ch0 timeout!\r\n");
+        ok = ok && pollChannel(2, myADC2_BASE, ADC_SOC_NUMBER11, 1, "\r\nERROR: ADC2 ch1 timeout!\r\n");
+        SAMPLE_PAUSE();
+    }
+#endif
+
+    GPIO_writePin(myBoardLED0_GPIO, 1);
+
+    if(!ok)
+    {
+        markTestInvalid(2, testNumber);
+        return false;
+    }
+
+    storeTest(2, 0, testNumber);
+    storeTest(2, 1, testNumber);
+
+    return true;
+}
+
+bool runSingleTestADC3(uint16_t testNumber)
+{
+    bool ok = true;
+
+    //UART_writeString(" [ADC3] Sampling IN0, IN1, IN2, IN3...");
+    
+    resetSharedArrays(3);
+    GPIO_writePin(myBoardLED0_GPIO, 0);
+    startPWM();
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    ok = acquireEOS(3, "\r\nERROR: ADC3 EOS timeout!\r\n");
+#else
+    while(ok && (adcSampleCount[0] < sweepCfg.samples ||
+                 adcSampleCount[1] < sweepCfg.samples ||
+                 adcSampleCount[2] < sweepCfg.samples ||
+                 adcSampleCount[3] < sweepCfg.samples))
+    {
+        ok = ok && pollChannel(3, myADC3_BASE, ADC_SOC_NUMBER4, 0, "\r\nERROR: ADC3 ch0 timeout!\r\n");
+        ok = ok && pollChannel(3, myADC3_BASE, ADC_SOC_NUMBER5, 1, "\r\nERROR: ADC3 ch1 timeout!\r\n");
+        ok = ok && pollChannel(3, myADC3_BASE, ADC_SOC_NUMBER6, 2, "\r\nERROR: ADC3 ch2 timeout!\r\n");
+        ok = ok && pollChannel(3, myADC3_BASE, ADC_SOC_NUMBER7, 3, "\r\nERROR: ADC3 ch3 timeout!\r\n");
+        SAMPLE_PAUSE();
+    }
+#endif
+
+    GPIO_writePin(myBoardLED0_GPIO, 1);
+
+    if(!ok)
+    {
+        markTestInvalid(3, testNumber);
+        return false;
+    }
+
+    storeTest(3, 0, testNumber);
+    storeTest(3, 1, testNumber);
+    storeTest(3, 2, testNumber);
+    storeTest(3, 3, testNumber);
+
+    return true;
+}
+
+/********************************************************************************
+ * Window Average Calculators
+ *******************************************************************************/
+static void averageChannel(uint16_t row, uint16_t winIdx)
+{
+    const uint16_t* mn = testStore.min[row];
+    const uint16_t* mx = testStore.max[row];
+    const uint16_t* av = testStore.avg[row];
+    const uint32_t* var = testStore.var[row];
+    uint16_t j;
+    uint16_t n = 0;
+    uint32_t sumMin = 0, sumMax = 0, sumAvg = 0;
+    uint64_t sumVar = 0;
+
+    for(j = 0; j < sweepCfg.tests; j++)
+    {
+        if(!validBit(testStore.valid[row], j)) continue;
+        n++;
+        sumMin += mn[j];
+        sumMax += mx[j];
+        sumAvg += av[j];
+        sumVar += var[j];
+    }
+    putValidBit(windowStore.valid[row], winIdx, n != 0);
+    if(n == 0) return;
+
+    /* Average over the tests that completed - invalid ones are excluded.
+     * StdDev comes from the mean variance, the noise pooled over the tests. */
+    windowStore.min[row][winIdx] = (uint16_t)(sumMin / n);
+    windowStore.max[row][winIdx] = (uint16_t)(sumMax / n);
+    windowStore.avg[row][winIdx] = (uint16_t)(sumAvg / n);
+    windowStore.var[row][winIdx] = (uint32_t)(sumVar / n);
+}
+
+void calculateWindowAverageADC0(uint16_t windowIndex)
+{
+    uint16_t ch;
+    for(ch = 0; ch < ADC0_NUM_CH; ch++)
+        averageChannel(RES_ROW(0, ch), windowIndex);
+}
+
+void calculateWindowAverageADC1(uint16_t windowIndex)
+{
+    uint16_t ch;
+    for(ch = 0; ch < ADC1_NUM_CH; ch++)
+        averageChannel(RES_ROW(1, ch), windowIndex);
+}
+
+void calculateWindowAverageADC2(uint16_t windowIndex)
+{
+    uint16_t ch;
+    for(ch = 0; ch < ADC2_NUM_CH; ch++)
+        averageChannel(RES_ROW(2, ch), windowIndex);
+}
+
+void calculateWindowAverageADC3(uint16_t windowIndex)
+{
+    uint16_t ch;
+    for(ch = 0; ch < ADC3_NUM_CH; ch++)
+        averageChannel(RES_ROW(3, ch), windowIndex);
+}
+
+/********************************************************************************
+ * Final Table Display
+ *******************************************************************************/
+void displayFinalTableADC0(void)
+{
+    uint16_t w;
+    printTableHeader("ADC0", "ADCIN0 (SOC0)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(0, 0), w);
+    printTableHeader("ADC0", "ADCIN2 (SOC1)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(0, 1), w);
+    printTableHeader("ADC0", "ADCIN4 (SOC2)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(0, 2), w);
+}
+
+void displayFinalTableADC1(void)
+{
+    uint16_t w;
+    printTableHeader("ADC1", "ADCIN0 (SOC3)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(1, 0), w);
+    printTableHeader("ADC1", "ADCIN2 (SOC8)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(1, 1), w);
+    printTableHeader("ADC1", "ADCIN4 (SOC9)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(1, 2), w);
+}
+
+void displayFinalTableADC2(void)
+{
+    uint16_t w;
+    printTableHeader("ADC2", "ADCIN2 (SOC10)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(2, 0), w);
+    printTableHeader("ADC2", "ADCIN4 (SOC11)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(2, 1), w);
+}
+
+void displayFinalTableADC3(void)
+{
+    uint16_t w;
+    printTableHeader("ADC3", "ADCIN0 (SOC4)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(3, 0), w);
+    printTableHeader("ADC3", "ADCIN1 (SOC5)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(3, 1), w);
+    printTableHeader("ADC3", "ADCIN2 (SOC6)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(3, 2), w);
+    printTableHeader("ADC3", "ADCIN3 (SOC7)");
+    for(w = 0; w < sweepNumWindows(); w++) printWindowRow(RES_ROW(3, 3), w);
+}
+
+/********************************************************************************
+ * Run settings
+ *******************************************************************************/
+uint16_t sweepNumWindows(void)
+{
+    return (sweepCfg.winEnd - sweepCfg.winStart) / sweepCfg.winStep + 1U;
+}
+
+uint16_t windowCycles(uint16_t windowIndex)
+{
+    return sweepCfg.winStart + windowIndex * sweepCfg.winStep;
+}
+
+/* Limits the result arrays and sample pool were sized for */
+static bool configValid(const SweepConfig* c)
+{
+    uint16_t a;
+
+    if(c->winStart < 1U || c->winEnd < c->winStart || c->winEnd >= ACQ_WINDOW_MAX ||
+       c->winStep < 1U || (c->winEnd - c->winStart) / c->winStep + 1U > NUM_WINDOWS)
+        return false;
+    if(c->tests < 1U || c->tests > TESTS_PER_WINDOW) return false;
+    if(c->samples < 1U || c->samples > MAX_SAMPLES_PER_TEST) return false;
+    if(c->format > OUTPUT_CSV) return false;
+    /* 12-bit sweeps may go under the S+H minimum to find where it breaks;
+     * 16-bit windows start at the datasheet minimum */
+    if(c->resolution == ADC_RESOLUTION_16BIT)
+    {
+        if(c->winStart < ADC_MIN_ACQ_16BIT) return false;
+    }
+    else if(c->resolution != ADC_RESOLUTION_12BIT) return false;
+    for(a = 0; a < NUM_ADCS; a++)
+        if(c->chanMask[a] >= (1U << adcPaths[a].numCh) && c->chanMask[a] != 0xFU) return false;
+    return true;
+}
+
+/* Carve one sweepCfg.samples buffer per channel out of samplePool */
+static void allocSampleBuffers(void)
+{
+    uint16_t ch;
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+        adcResults[ch] = &samplePool[ch * sweepCfg.samples];
+}
+
+static const ADC_ClkPrescale gridDivs[GRID_NUM_DIVS] = GRID_DIVS;
+
+/* Grid settings the device can run: 12-bit single-ended or 16-bit
+ * differential, ADCCLK <= 50 MHz, window at least that resolution's S+H */
+static bool gridPointSupported(const GridPoint* g)
+{
+    bool is16 = (g->resolution == ADC_RESOLUTION_16BIT);
+
+    if(is16 != (g->mode == ADC_MODE_DIFFERENTIAL)) return false;
+    if(g->prescale < GRID_MIN_DIV || g->prescale > ADC_CLK_DIV_8_0) return false;
+    if(g->window < (is16 ? ADC_MIN_ACQ_16BIT : ADC_MIN_ACQ_12BIT) || g->window >= ACQ_WINDOW_MAX)
+        return false;
+    return true;
+}
+
+/* S+H plus conversion, SYSCLK cycles */
+uint16_t gridSampleCycles(const GridPoint* g)
+{
+    return g->window + adcConvCycles(g->prescale, g->resolution);
+}
+
+/********************************************************************************
+ * Sweep checkpoint - results arrays and this header share NOINIT RAM
+ *******************************************************************************/
+static uint16_t checkpointSum(const SweepCheckpoint* c)
+{
+    const uint16_t* w = (const uint16_t*)&c->cfg;
+    uint16_t i, sum = 0;
+
+    for(i = 0; i < sizeof(SweepConfig) / sizeof(uint16_t); i++)
+        sum = (uint16_t)((sum << 1) | (sum >> 15)) ^ w[i];     /* rotate-xor */
+    return (uint16_t)(c->magic ^ c->tag ^ c->phase ^ (c->window << 5) ^ (c->test << 10) ^
+                      sum ^ 0xA5A5u);
+}
+
+void saveCheckpoint(uint16_t phase, uint16_t window, uint16_t test)
+{
+    sweepCheckpoint.magic = CHECKPOINT_MAGIC;
+    sweepCheckpoint.tag = CHECKPOINT_TAG;
+    sweepCheckpoint.phase = phase;
+    sweepCheckpoint.window = window;
+    sweepCheckpoint.test = test;
+    sweepCheckpoint.cfg = sweepCfg;
+    sweepCheckpoint.checksum = checkpointSum(&sweepCheckpoint);
+}
+
+bool checkpointValid(void)
+{
+    const SweepConfig* c = &sweepCheckpoint.cfg;
+    return sweepCheckpoint.magic == CHECKPOINT_MAGIC &&
+           sweepCheckpoint.tag == CHECKPOINT_TAG &&
+           sweepCheckpoint.checksum == checkpointSum(&sweepCheckpoint) &&
+           configValid(c) &&
+           sweepCheckpoint.phase < NUM_PHASES &&
+           sweepCheckpoint.window <= (c->winEnd - c->winStart) / c->winStep + 1U &&
+           sweepCheckpoint.test < c->tests;
+}
+
+void clearCheckpoint(void)
+{
+    sweepCheckpoint.magic = 0;
+    sweepCheckpoint.checksum = 0;
+}
+
+/********************************************************************************
+ * Results output - the fixed-width tables, or one CSV line per window
+ *******************************************************************************/
+static uint16_t lastPhase;
+
+static void displayPhaseCSV(uint16_t phase)
+{
+    WindowStats st;
+    WindowStats* s = &st;
+    uint16_t a, ch, w;
+
+    UART_writeString("phase,adc,pin,bits,cycles,min,max,avg,range,stddev,valid\r\n");
+    for(a = 0; a < NUM_ADCS; a++)
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+            for(w = 0; w < sweepNumWindows(); w++)
+            {
+                uint32_t sd;
+                loadWindowResult(RES_ROW(a, ch), w, s);
+                sd = varStdX100(s->var);
+                sprintf(uartBuffer, "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u.%02u,%u\r\n",
+                        phase + 1, a, (uint16_t)adcPaths[a].phaseCh[phase][ch],
+                        sweepCfg.resolution == ADC_RESOLUTION_16BIT ? 16U : 12U,
+                        windowCycles(w), s->min, s->max, s->avg, s->range,
+                        (uint16_t)(sd / 100U), (uint16_t)(sd % 100U), (uint16_t)s->valid);
+                UART_writeString(uartBuffer);
+            }
+}
+
+void displayPhaseResults(uint16_t phase)
+{
+    lastPhase = phase;
+    if(sweepCfg.format == OUTPUT_CSV)
+    {
+        displayPhaseCSV(phase);
+        return;
+    }
+    displayFinalTableADC0();
+    displayFinalTableADC1();
+    displayFinalTableADC2();
+    displayFinalTableADC3();
+}
+
+/********************************************************************************
+ * UART command shell - replaces the "press any key" gate. One command per
+ * line; "run" / "resume" return to main, which runs the sweep and comes back.
+ *******************************************************************************/
+static const char shellHelp[] =
+    "Commands:\r\n"
+    "  show                      current settings\r\n"
+    "  win <start> <end> [step]  acquisition windows, SYSCLK cycles\r\n"
+    "  tests <n>                 tests per window\r\n"
+    "  samples <n>               samples per test\r\n"
+    "  delay <us>                pause between sample rounds\r\n"
+    "  mask <adc> <hex>          channels swept on one ADC\r\n"
+    "  format table|csv          final results layout\r\n"
+    "  res 12|16                 12-bit single-ended / 16-bit differential\r\n"
+    "  run | resume              start a sweep / continue the checkpoint\r\n"
+    "  dump                      print the last phase's results again\r\n"
+    "  scope | coh               scope capture / coherent average\r\n"
+    "  cell <win> <div> 12|16    add a grid cell (div 4..8, .5 steps)\r\n"
+    "  cell clear                empty the cell list\r\n"
+    "  grid [1|2]                run the cell list, or win x div x mode\r\n"
+    "  cells                     print the last grid's results again\r\n"
+    "  log [0|1|2]               event log: errors / +windows / +every test\r\n"
+    "  rate <win> [1|2]          pause axis 200 us .. 0, achieved MSPS\r\n"
+    "  bench                     hot path placement, ISR latency, test time\r\n"
+    "  order <adc> [1|2]         predecessor error per window, best SOC order\r\n"
+#if STIM_DAC
+    "  xtalk [1|2]               simultaneous 4-ADC crosstalk matrix / skew\r\n"
+#endif
+    "  A or ESC during a run aborts it\r\n";
+
+/* A or ESC waiting in the SCI FIFO */
+static bool abortRequested(void)
+{
+    char c;
+    if(SCI_getRxFIFOStatus(mySCI0_BASE) == SCI_FIFO_RX0) return false;
+    c = (char)SCI_readCharNonBlocking(mySCI0_BASE);
+    return c == 'a' || c == 'A' || c == 0x1B;
+}
+
+/* Read one line with echo and backspace handling */
+static void shellReadLine(char* line)
+{
+    uint16_t n = 0;
+    char c;
+
+    for(;;)
+    {
+        c = UART_readChar();
+        if(c == '\r' || c == '\n')
+        {
+            if(n == 0) continue;
+            UART_writeString("\r\n");
+            break;
+        }
+        if((c == '\b' || c == 0x7F) && n > 0)
+        {
+            n--;
+            UART_writeString("\b \b");
+        }
+        else if(c >= ' ' && n < SHELL_LINE_MAX - 1)
+        {
+            line[n++] = c;
+            UART_writeChar(c);
+        }
+    }
+    line[n] = '\0';
+}
+
+static void shellShow(void)
+{
+    uint16_t a;
+
+    sprintf(uartBuffer, "  win %u..%u step %u (%u windows)\r\n  tests %u  samples %u  delay %u us  format %s\r\n  res %s\r\n",
+            sweepCfg.winStart, sweepCfg.winEnd, sweepCfg.winStep, sweepNumWindows(),
+            sweepCfg.tests, sweepCfg.samples, sweepCfg.delayUs,
+            sweepCfg.format == OUTPUT_CSV ? "csv" : "table",
+            sweepCfg.resolution == ADC_RESOLUTION_16BIT ? "16-bit differential (even pins only)" : "12-bit single-ended");
+    UART_writeString(uartBuffer);
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        sprintf(uartBuffer, "  mask ADC%u %X\r\n", a, sweepCfg.chanMask[a] & ((1U << adcPaths[a].numCh) - 1U));
+        UART_writeString(uartBuffer);
+    }
+    sprintf(uartBuffer, "  limits: %u windows, %u tests, %u samples, 16-bit window >= %u\r\n",
+            (uint16_t)NUM_WINDOWS, (uint16_t)TESTS_PER_WINDOW, (uint16_t)MAX_SAMPLES_PER_TEST,
+            (uint16_t)ADC_MIN_ACQ_16BIT);
+    UART_writeString(uartBuffer);
+}
+
+/* Numeric argument k (1-based) of the tokenised line, base 0 = auto / 16 */
+static uint16_t shellArg(char* const* argv, uint16_t argc, uint16_t k, int base, uint16_t dflt)
+{
+    return (k < argc) ? (uint16_t)strtoul(argv[k], NULL, base) : dflt;
+}
+
+/* ADC clock divider "4", "4.5" .. "8" -> ADC_ClkPrescale (2 x div - 2) */
+static uint16_t shellClkDiv(const char* s)
+{
+    char* end;
+    uint16_t x2 = (uint16_t)strtoul(s, &end, 10) * 2U;
+    if(end[0] == '.' && end[1] == '5') x2++;
+    return (x2 >= 2U) ? x2 - 2U : 0U;
+}
+
+uint16_t runShell(void)
+{
+    char line[SHELL_LINE_MAX];
+    char* argv[6];
+    uint16_t argc;
+    SweepConfig next;
+
+    UART_writeString("\r\nADC sweep shell - 'help' for commands\r\n");
+    if(checkpointValid())
+    {
+        sprintf(uartBuffer, "Checkpoint found: Phase %u, window %u, test %u - 'resume' to continue\r\n",
+                sweepCheckpoint.phase + 1,
+                sweepCheckpoint.cfg.winStart + sweepCheckpoint.window * sweepCheckpoint.cfg.winStep,
+                sweepCheckpoint.test);
+        UART_writeString(uartBuffer);
+    }
+
+    for(;;)
+    {
+        UART_writeString("> ");
+        shellReadLine(line);
+        argc = 0;
+        argv[argc] = strtok(line, " \t");
+        while(argv[argc] != NULL && argc < 5) argv[++argc] = strtok(NULL, " \t");
+        if(argc == 0) continue;
+
+        next = sweepCfg;
+        if(strcmp(argv[0], "help") == 0)
+        {
+            UART_writeString(shellHelp);
+            continue;
+        }
+        else if(strcmp(argv[0], "show") == 0)
+        {
+            shellShow();
+            continue;
+        }
+        else if(strcmp(argv[0], "run") == 0)
+        {
+            return SHELL_RUN;
+        }
+        else if(strcmp(argv[0], "resume") == 0)
+        {
+            if(checkpointValid()) return SHELL_RESUME;
+            UART_writeString("No valid checkpoint\r\n");
+            continue;
+        }
+        else if(strcmp(argv[0], "dump") == 0)
+        {
+            displayPhaseResults(lastPhase);
+            continue;
+        }
+        else if(strcmp(argv[0], "scope") == 0)
+        {
+            if(runScopeCapture(SCOPE_ADC, adcPaths[SCOPE_ADC].phaseCh[0][SCOPE_CH]))
+                displayScopeCapture();
+            else
+                UART_writeString("Scope: no trigger before timeout\r\n");
+            continue;
+        }
+        else if(strcmp(argv[0], "coh") == 0)
+        {
+            if(runCoherentAverage(SCOPE_ADC, 0, COH_REPS))
+                displayCoherentAverage();
+            else
+                UART_writeString("Coherent: run failed - no waveform kept\r\n");
+            continue;
+        }
+        else if(strcmp(argv[0], "grid") == 0)
+        {
+            cellPhase = (shellArg(argv, argc, 1, 0, 1) == 2) ? 1U : 0U;
+            return SHELL_GRID;
+        }
+        else if(strcmp(argv[0], "rate") == 0 && argc >= 2 &&
+                shellArg(argv, argc, 1, 0, 0) >= 1U && shellArg(argv, argc, 1, 0, 0) < ACQ_WINDOW_MAX)
+        {
+            rateWindow = shellArg(argv, argc, 1, 0, 0);
+            cellPhase = (shellArg(argv, argc, 2, 0, 1) == 2) ? 1U : 0U;
+            return SHELL_RATE;
+        }
+        else if(strcmp(argv[0], "bench") == 0)
+        {
+            return SHELL_BENCH;
+        }
+        else if(strcmp(argv[0], "order") == 0 && argc >= 2 && shellArg(argv, argc, 1, 0, NUM_ADCS) < NUM_ADCS)
+        {
+            runOrderScan(shellArg(argv, argc, 1, 0, 0), (shellArg(argv, argc, 2, 0, 1) == 2) ? 1U : 0U);
+            displayOrderScan();
+            continue;
+        }
+#if STIM_DAC
+        else if(strcmp(argv[0], "xtalk") == 0)
+        {
+            runCrosstalk((shellArg(argv, argc, 1, 0, 1) == 2) ? 1U : 0U);
+            displayCrosstalk();
+            continue;
+        }
+#endif
+        else if(strcmp(argv[0], "log") == 0)
+        {
+            logVerbosity = shellArg(argv, argc, 1, 0, logVerbosity);
+            drainEventLog(true);
+            continue;
+        }
+        else if(strcmp(argv[0], "cells") == 0)
+        {
+            displayGridResults();
+            continue;
+        }
+        else if(strcmp(argv[0], "cell") == 0 && argc == 2 && strcmp(argv[1], "clear") == 0)
+        {
+            gridListCount = 0;
+            continue;
+        }
+        else if(strcmp(argv[0], "cell") == 0 && argc == 4)
+        {
+            GridPoint g;
+            g.window = shellArg(argv, argc, 1, 0, 0);
+            g.prescale = shellClkDiv(argv[2]);
+            g.resolution = (shellArg(argv, argc, 3, 0, 12) == 16) ? ADC_RESOLUTION_16BIT : ADC_RESOLUTION_12BIT;
+            g.mode = (g.resolution == ADC_RESOLUTION_16BIT) ? ADC_MODE_DIFFERENTIAL : ADC_MODE_SINGLE_ENDED;
+            if(gridListCount >= GRID_MAX_CELLS || !gridPointSupported(&g))
+            {
+                UART_writeString("Rejected - list full, divider below 4 or window below the S+H minimum\r\n");
+                continue;
+            }
+            gridList[gridListCount++] = g;
+            sprintf(uartBuffer, "  %u cells listed\r\n", gridListCount);
+            UART_writeString(uartBuffer);
+            continue;
+        }
+        else if(strcmp(argv[0], "win") == 0 && argc >= 3)
+        {
+            next.winStart = shellArg(argv, argc, 1, 0, next.winStart);
+            next.winEnd = shellArg(argv, argc, 2, 0, next.winEnd);
+            next.winStep = shellArg(argv, argc, 3, 0, 1);
+        }
+        else if(strcmp(argv[0], "tests") == 0 && argc == 2)
+            next.tests = shellArg(argv, argc, 1, 0, next.tests);
+        else if(strcmp(argv[0], "samples") == 0 && argc == 2)
+            next.samples = shellArg(argv, argc, 1, 0, next.samples);
+        else if(strcmp(argv[0], "delay") == 0 && argc == 2)
+            next.delayUs = shellArg(argv, argc, 1, 0, next.delayUs);
+        else if(strcmp(argv[0], "mask") == 0 && argc == 3 && shellArg(argv, argc, 1, 0, NUM_ADCS) < NUM_ADCS)
+            next.chanMask[shellArg(argv, argc, 1, 0, 0)] = shellArg(argv, argc, 2, 16, 0);
+        else if(strcmp(argv[0], "format") == 0 && argc == 2 && strcmp(argv[1], "csv") == 0)
+            next.format = OUTPUT_CSV;
+        else if(strcmp(argv[0], "format") == 0 && argc == 2 && strcmp(argv[1], "table") == 0)
+            next.format = OUTPUT_TABLE;
+        else if(strcmp(argv[0], "res") == 0 && argc == 2 && shellArg(argv, argc, 1, 0, 0) == 12)
+            next.resolution = ADC_RESOLUTION_12BIT;
+        else if(strcmp(argv[0], "res") == 0 && argc == 2 && shellArg(argv, argc, 1, 0, 0) == 16)
+            next.resolution = ADC_RESOLUTION_16BIT;
+        else
+        {
+            UART_writeString("? 'help' lists the commands\r\n");
+            continue;
+        }
 
-    displayFinalTableADC0();
-    displayFinalTableADC1();
-    displayFinalTableADC2();
-    displayFinalTableADC3();
+        if(!configValid(&next))
+        {
+            UART_writeString("Rejected - outside the compiled limits ('show')\r\n");
+            continue;
+        }
+        sweepCfg = next;
+        shellShow();
+    }
+}
 
-    /* PHASE 2 */
-    delayMs(500);
-    UART_writeString("\r\n===========PHASE 2 Of the TEST...============\r\n\r\n");
+/* Window averages of the scheduled channels into the event log */
+static void logWindowResults(uint16_t windowIndex)
+{
+    WindowStats s;
+    uint16_t a, ch;
+
+    for(a = 0; a < NUM_ADCS; a++)
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            if(!(scheduledMask(a) & (1U << ch))) continue;
+            loadWindowResult(RES_ROW(a, ch), windowIndex, &s);
+            if(s.valid)
+                logStats(LOG_WINDOW, a, ch, windowCycles(windowIndex), sweepCfg.tests, &s);
+        }
+}
+
+/********************************************************************************
+ * One sweep phase - Phase 1 on the original pins, Phase 2 on the remaining pins
+ * with the ADC order reversed. Resumes at (startWindow, startTest).
+ *******************************************************************************/
+static bool runPhase(uint16_t phase, uint16_t startWindow, uint16_t startTest)
+{
+    uint16_t i, j;
+    uint16_t currentWindow;
 
-    for(i = 0; i < NUM_WINDOWS; i++)
+    sweepPhase = phase;
+    for(i = startWindow; i < sweepNumWindows(); i++)
     {
-        currentWindow = ACQ_WINDOW_START + i;
+        currentWindow = windowCycles(i);
+        logWindow = currentWindow;
         sprintf(uartBuffer, "\r\n=== Window %2u cycles (%uns) ===\r\n",
                 currentWindow, currentWindow * 5);
         UART_writeString(uartBuffer);
 
         stopEPWMs();
+        resetLatencyStats();
+        resetDropStats();
+        resetRateStats();
+#if PPB_DELAY_MONITOR
+        resetDelayStats();
+#endif
+#if LIMIT_MONITOR
+        resetLimitLog();
+#endif
+#if SKEW_MONITOR
+        resetSkewStats();
+        measureSkew();
+#endif
         delayMs(5);
 
-        ReconfigureandsetAcquisitionWindowADC0(currentWindow);
-        ReconfigureandsetAcquisitionWindowADC1(currentWindow);
-        ReconfigureandsetAcquisitionWindowADC2(currentWindow);
-        ReconfigureandsetAcquisitionWindowADC3(currentWindow);
+        if(phase == 0)
+        {
+            setAcquisitionWindowADC0(currentWindow);
+            setAcquisitionWindowADC1(currentWindow);
+            setAcquisitionWindowADC2(currentWindow);
+            setAcquisitionWindowADC3(currentWindow);
+        }
+        else
+        {
+            ReconfigureandsetAcquisitionWindowADC0(currentWindow);
+            ReconfigureandsetAcquisitionWindowADC1(currentWindow);
+            ReconfigureandsetAcquisitionWindowADC2(currentWindow);
+            ReconfigureandsetAcquisitionWindowADC3(currentWindow);
+        }
         delayMs(10);
 
-        for(j = 0; j < TESTS_PER_WINDOW; j++)
+        for(j = (i == startWindow) ? startTest : 0; j < sweepCfg.tests; j++)
         {
-            runSingleTestADC3(j);
-            delayMs(20);
-            runSingleTestADC1(j);
-            delayMs(20);
-            runSingleTestADC2(j);
-            delayMs(20);
-            runSingleTestADC0(j);
-            delayMs(20);
+            if(abortRequested())
+            {
+                stopEPWMs();
+                saveCheckpoint(phase, i, j);
+                UART_writeString("\r\nRun aborted - 'resume' continues from here\r\n");
+                return false;
+            }
+            if(phase == 0)
+            {
+                runScheduledTest(runSingleTestADC0, 0, j);  // Uses shared arrays, stores to the ADC0 rows of testStore
+                runScheduledTest(runSingleTestADC1, 1, j);  // Uses shared arrays, stores to the ADC1 rows of testStore
+                runScheduledTest(runSingleTestADC2, 2, j);  // Uses shared arrays, stores to the ADC2 rows of testStore
+                runScheduledTest(runSingleTestADC3, 3, j);  // Uses shared arrays, stores to the ADC3 rows of testStore
+            }
+            else
+            {
+                runScheduledTest(runSingleTestADC3, 3, j);
+                runScheduledTest(runSingleTestADC1, 1, j);
+                runScheduledTest(runSingleTestADC2, 2, j);
+                runScheduledTest(runSingleTestADC0, 0, j);
+            }
+            if(j + 1 < sweepCfg.tests) saveCheckpoint(phase, i, j + 1);
         }
 
         calculateWindowAverageADC0(i);
         calculateWindowAverageADC1(i);
         calculateWindowAverageADC2(i);
         calculateWindowAverageADC3(i);
+#if EVENT_LOG
+        logWindowResults(i);
+#endif
+        displayLatencyStats();
+        displayDropStats();
+        displayRateStats();
+#if PPB_DELAY_MONITOR
+        displayDelayStats();
+#endif
+#if LIMIT_MONITOR
+        displayLimitLog();
+#endif
+#if SKEW_MONITOR
+        displaySkewStats();
+#endif
+#if EVENT_LOG
+        drainEventLog(false);
+#endif
+        saveCheckpoint(phase, i + 1, 0);
 
         delayMs(100);
     }
@@ -738,17 +3513,591 @@ void main(void)
     stopEPWMs();
 
     UART_writeString("\r\n\r\n========================================================\r\n");
-    UART_writeString("               PHASE 2 FINAL RESULTS                    \r\n");
+    UART_writeString(phase == 0 ? "               PHASE 1 FINAL RESULTS                    \r\n"
+                                : "               PHASE 2 FINAL RESULTS                    \r\n");
     UART_writeString("========================================================\r\n");
 
-    displayFinalTableADC0();
-    displayFinalTableADC1();
-    displayFinalTableADC2();
-    displayFinalTableADC3();
+    displayPhaseResults(phase);
+    return true;
+}
+
+/********************************************************************************
+ * Grid sweep - every cell reconfigures the converters (only when the divider
+ * or mode changes), sets its window and runs sweepCfg.tests tests. Window
+ * results go through window index 0 of the result arrays and are copied into
+ * gridCells[].
+ *******************************************************************************/
+/* Cartesian plan: mode outermost, window innermost, so the converters are
+ * reconfigured once per (mode, divider) */
+static uint16_t planGrid(void)
+{
+    static const uint16_t res[2] = { ADC_RESOLUTION_12BIT, ADC_RESOLUTION_16BIT };
+    static const uint16_t mode[2] = { ADC_MODE_SINGLE_ENDED, ADC_MODE_DIFFERENTIAL };
+    uint16_t r, m, d, w;
+    uint16_t skipped = 0;
+    GridPoint g;
+
+    gridNumCells = 0;
+    for(r = 0; r < 2; r++)
+        for(m = 0; m < 2; m++)
+            for(d = 0; d < GRID_NUM_DIVS; d++)
+                for(w = 0; w < sweepNumWindows(); w++)
+                {
+                    g.window = windowCycles(w);
+                    g.prescale = gridDivs[d];
+                    g.resolution = res[r];
+                    g.mode = mode[m];
+                    if(!gridPointSupported(&g) || gridNumCells >= GRID_MAX_CELLS)
+                    {
+                        skipped++;
+                        continue;
+                    }
+                    gridCells[gridNumCells++].pt = g;
+                }
+    return skipped;
+}
+
+static void storeGridCell(GridCell* c)
+{
+    WindowStats st;
+    WindowStats* s = &st;
+    uint16_t a, ch;
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        c->validMask[a] = 0;
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            loadWindowResult(RES_ROW(a, ch), 0, s);
+            if(!s->valid || !(scheduledMask(a) & (1U << ch))) continue;
+            c->avg[a][ch] = s->avg;
+            c->range[a][ch] = s->range;
+            c->stdX100[a][ch] = varStdX100Sat(s->var);
+            c->validMask[a] |= 1U << ch;
+        }
+    }
+}
+
+/* Largest std dev of the cell on the 12-bit scale, 0xFFFF if nothing valid */
+static uint16_t gridWorstStd(const GridCell* c)
+{
+    uint16_t a, ch;
+    uint16_t worst = 0;
+    bool any = false;
+
+    for(a = 0; a < NUM_ADCS; a++)
+        for(ch = 0; ch < adcPaths[a].numCh; ch++)
+        {
+            uint16_t sd;
+            if(!(c->validMask[a] & (1U << ch))) continue;
+            sd = (c->pt.resolution == ADC_RESOLUTION_16BIT) ? c->stdX100[a][ch] >> 4 : c->stdX100[a][ch];
+            if(sd > worst) worst = sd;
+            any = true;
+        }
+    return any ? worst : 0xFFFFU;
+}
+
+static bool runGridCell(GridCell* c)
+{
+    uint16_t j;
+    uint16_t win = c->pt.window;
+
+    stopEPWMs();
+    resetLatencyStats();
+    resetDropStats();
+    resetRateStats();
+    logWindow = win;
+    if(cellPhase == 0)
+    {
+        setAcquisitionWindowADC0(win);
+        setAcquisitionWindowADC1(win);
+        setAcquisitionWindowADC2(win);
+        setAcquisitionWindowADC3(win);
+    }
+    else
+    {
+        ReconfigureandsetAcquisitionWindowADC0(win);
+        ReconfigureandsetAcquisitionWindowADC1(win);
+        ReconfigureandsetAcquisitionWindowADC2(win);
+        ReconfigureandsetAcquisitionWindowADC3(win);
+    }
+    delayMs(10);
+
+    for(j = 0; j < sweepCfg.tests; j++)
+    {
+        if(abortRequested()) return false;
+        if(cellPhase == 0)
+        {
+            runScheduledTest(runSingleTestADC0, 0, j);
+            runScheduledTest(runSingleTestADC1, 1, j);
+            runScheduledTest(runSingleTestADC2, 2, j);
+            runScheduledTest(runSingleTestADC3, 3, j);
+        }
+        else
+        {
+            runScheduledTest(runSingleTestADC3, 3, j);
+            runScheduledTest(runSingleTestADC1, 1, j);
+            runScheduledTest(runSingleTestADC2, 2, j);
+            runScheduledTest(runSingleTestADC0, 0, j);
+        }
+    }
+    calculateWindowAverageADC0(0);
+    calculateWindowAverageADC1(0);
+    calculateWindowAverageADC2(0);
+    calculateWindowAverageADC3(0);
+    storeGridCell(c);
+    return true;
+}
+
+static void printGridPoint(const GridPoint* g)
+{
+    sprintf(uartBuffer, "win %3u div %u.%u %u-bit %-4s (%u cyc/sample)",
+            g->window, (g->prescale + 2U) / 2U, ((g->prescale + 2U) & 1U) * 5U,
+            g->resolution == ADC_RESOLUTION_16BIT ? 16U : 12U,
+            g->mode == ADC_MODE_DIFFERENTIAL ? "diff" : "se", gridSampleCycles(g));
+    UART_writeString(uartBuffer);
+}
+
+/* Run the shell's cell list, or the Cartesian grid when the list is empty;
+ * false if aborted. The converters are back at the board.c setup after. */
+static bool runGridSweep(void)
+{
+    uint16_t i, sd;
+    uint16_t skipped = 0;
+    bool done = true;
+    const GridPoint* last = NULL;
+
+    allocSampleBuffers();
+    sweepPhase = cellPhase;
+    if(gridListCount != 0)
+    {
+        for(gridNumCells = 0; gridNumCells < gridListCount; gridNumCells++)
+            gridCells[gridNumCells].pt = gridList[gridNumCells];
+    }
+    else
+        skipped = planGrid();
+
+    sprintf(uartBuffer, "\r\nGrid sweep: Phase %u, %u cells (%u skipped - unsupported or over %u), %u tests x %u samples\r\n",
+            cellPhase + 1U, gridNumCells, skipped, (uint16_t)GRID_MAX_CELLS, sweepCfg.tests, sweepCfg.samples);
+    UART_writeString(uartBuffer);
+    UART_writeString("Press A or ESC to abort\r\n");
+
+    for(i = 0; i < gridNumCells; i++)
+    {
+        GridCell* c = &gridCells[i];
+        if(last == NULL || last->prescale != c->pt.prescale ||
+           last->resolution != c->pt.resolution || last->mode != c->pt.mode)
+            configureConverters((ADC_ClkPrescale)c->pt.prescale, (ADC_Resolution)c->pt.resolution,
+                                (ADC_SignalMode)c->pt.mode);
+        last = &c->pt;
+
+        if(!runGridCell(c))
+        {
+            gridNumCells = i;
+            done = false;
+            UART_writeString("\r\nGrid aborted\r\n");
+            break;
+        }
+        sprintf(uartBuffer, "  cell %2u ", i);
+        UART_writeString(uartBuffer);
+        printGridPoint(&c->pt);
+        sd = gridWorstStd(c);
+        sprintf(uartBuffer, " worst std %u.%02u\r\n", sd / 100U, sd % 100U);
+        UART_writeString(sd == 0xFFFFU ? " no valid channel\r\n" : uartBuffer);
+    }
+
+    stopEPWMs();
+    configureConverters(ADC_CLK_DIV_4_0, ADC_RESOLUTION_12BIT, ADC_MODE_SINGLE_ENDED);
+    displayGridResults();
+    return done;
+}
+
+void displayGridResults(void)
+{
+    uint16_t i, a, ch, sd;
+    uint16_t best = GRID_MAX_CELLS;
+
+    UART_writeString("cell,cycles,div_x2,bits,mode,sample_cyc,adc,pin,avg,range,stddev\r\n");
+    for(i = 0; i < gridNumCells; i++)
+    {
+        const GridCell* c = &gridCells[i];
+        for(a = 0; a < NUM_ADCS; a++)
+            for(ch = 0; ch < adcPaths[a].numCh; ch++)
+            {
+                if(!(c->validMask[a] & (1U << ch))) continue;
+                sprintf(uartBuffer, "%u,%u,%u,%u,%s,%u,%u,%u,%u,%u,%u.%02u\r\n",
+                        i, c->pt.window, c->pt.prescale + 2U,
+                        c->pt.resolution == ADC_RESOLUTION_16BIT ? 16U : 12U,
+                        c->pt.mode == ADC_MODE_DIFFERENTIAL ? "diff" : "se",
+                        gridSampleCycles(&c->pt), a, (uint16_t)adcPaths[a].phaseCh[cellPhase][ch],
+                        c->avg[a][ch], c->range[a][ch],
+                        c->stdX100[a][ch] / 100U, c->stdX100[a][ch] % 100U);
+                UART_writeString(uartBuffer);
+            }
+        if(gridWorstStd(c) <= GRID_STD_TARGET_X100 &&
+           (best == GRID_MAX_CELLS || gridSampleCycles(&c->pt) < gridSampleCycles(&gridCells[best].pt)))
+            best = i;
+    }
+
+    sprintf(uartBuffer, "Fastest cell with std <= %u.%02u LSB (12-bit scale): ",
+            (uint16_t)GRID_STD_TARGET_X100 / 100U, (uint16_t)GRID_STD_TARGET_X100 % 100U);
+    UART_writeString(uartBuffer);
+    if(best == GRID_MAX_CELLS)
+    {
+        UART_writeString("none\r\n");
+        return;
+    }
+    sd = gridWorstStd(&gridCells[best]);
+    sprintf(uartBuffer, "cell %u ", best);
+    UART_writeString(uartBuffer);
+    printGridPoint(&gridCells[best].pt);
+    sprintf(uartBuffer, " worst std %u.%02u\r\n", sd / 100U, sd % 100U);
+    UART_writeString(uartBuffer);
+}
+
+/********************************************************************************
+ * Sample-rate sweep - one window, RATE_DELAYS_US as the pause between sample
+ * rounds. Every step is a grid cell at the current converter setup; the
+ * slowest step is the reference for the degradation flag.
+ *******************************************************************************/
+/* Worst mean shift (LSB) and std dev growth (LSB x 100) of c against ref on one ADC */
+static void compareCells(const GridCell* ref, const GridCell* c, uint16_t adc,
+                         uint16_t* dAvg, uint16_t* dStd)
+{
+    uint16_t ch;
+    uint16_t both = ref->validMask[adc] & c->validMask[adc];
+
+    *dAvg = 0;
+    *dStd = 0;
+    for(ch = 0; ch < adcPaths[adc].numCh; ch++)
+    {
+        uint16_t d;
+        if(!(both & (1U << ch))) continue;
+        d = (c->avg[adc][ch] > ref->avg[adc][ch]) ? c->avg[adc][ch] - ref->avg[adc][ch]
+                                                  : ref->avg[adc][ch] - c->avg[adc][ch];
+        if(d > *dAvg) *dAvg = d;
+        if(c->stdX100[adc][ch] > ref->stdX100[adc][ch] &&
+           c->stdX100[adc][ch] - ref->stdX100[adc][ch] > *dStd)
+            *dStd = c->stdX100[adc][ch] - ref->stdX100[adc][ch];
+    }
+}
+
+static bool runRateSweep(void)
+{
+    static const uint16_t delays[RATE_NUM_STEPS] = RATE_DELAYS_US;
+    static GridCell steps[RATE_NUM_STEPS];
+    static uint32_t ksps[RATE_NUM_STEPS][NUM_ADCS];
+    uint16_t savedDelay = sweepCfg.delayUs;
+    uint16_t degradedAt[NUM_ADCS];
+    uint16_t i, a, n;
+    bool done = true;
+
+    allocSampleBuffers();
+    sweepPhase = cellPhase;
+    sprintf(uartBuffer, "\r\nRate sweep: Phase %u, window %u, %u tests x %u samples\r\n",
+            cellPhase + 1U, rateWindow, sweepCfg.tests, sweepCfg.samples);
+    UART_writeString(uartBuffer);
+    UART_writeString("Press A or ESC to abort\r\n");
+    UART_writeString(" Pause |  ADC0 MSPS  ADC1   ADC2   ADC3  | worst dAvg dStd\r\n");
+
+    for(a = 0; a < NUM_ADCS; a++) degradedAt[a] = RATE_NUM_STEPS;
+    for(n = 0; n < RATE_NUM_STEPS; n++)
+    {
+        GridCell* c = &steps[n];
+        uint16_t wAvg = 0, wStd = 0;
+
+        c->pt.window = rateWindow;
+        c->pt.prescale = ADC_CLK_DIV_4_0;
+        c->pt.resolution = ADC_RESOLUTION_12BIT;
+        c->pt.mode = ADC_MODE_SINGLE_ENDED;
+        sweepCfg.delayUs = delays[n];
+        if(!runGridCell(c))
+        {
+            done = false;
+            UART_writeString("\r\nRate sweep aborted\r\n");
+            break;
+        }
+
+        sprintf(uartBuffer, " %4uus|", delays[n]);
+        UART_writeString(uartBuffer);
+        for(a = 0; a < NUM_ADCS; a++)
+        {
+            uint16_t dAvg, dStd;
+            ksps[n][a] = achievedKsps(a);
+            sprintf(uartBuffer, " %2lu.%03lu", (unsigned long)(ksps[n][a] / 1000UL),
+                    (unsigned long)(ksps[n][a] % 1000UL));
+            UART_writeString(uartBuffer);
+            compareCells(&steps[0], c, a, &dAvg, &dStd);
+            if(dAvg > wAvg) wAvg = dAvg;
+            if(dStd > wStd) wStd = dStd;
+            if(degradedAt[a] == RATE_NUM_STEPS &&
+               (dAvg > RATE_AVG_TOL || dStd > RATE_STD_TOL_X100))
+                degradedAt[a] = n;
+        }
+        sprintf(uartBuffer, " | %4u %2u.%02u%s\r\n", wAvg, wStd / 100U, wStd % 100U,
+                (wAvg > RATE_AVG_TOL || wStd > RATE_STD_TOL_X100) ? "  DEGRADED" : "");
+        UART_writeString(uartBuffer);
+    }
+
+    sweepCfg.delayUs = savedDelay;
+    stopEPWMs();
+
+    /* Ceiling per ADC - the fastest step before the first degraded one */
+    for(a = 0; a < NUM_ADCS && n > 0; a++)
+    {
+        i = (degradedAt[a] < n) ? degradedAt[a] : n;
+        if(i == 0)
+            sprintf(uartBuffer, "  ADC%u: no valid steps\r\n", a);
+        else
+            sprintf(uartBuffer, "  ADC%u: clean to %2lu.%03lu MSPS (pause %u us)%s\r\n", a,
+                    (unsigned long)(ksps[i - 1][a] / 1000UL), (unsigned long)(ksps[i - 1][a] % 1000UL),
+                    delays[i - 1], (degradedAt[a] < n) ? ", degrades faster" : "");
+        UART_writeString(uartBuffer);
+    }
+    return done;
+}
+
+/********************************************************************************
+ * Hot path benchmark - one test per ADC at the first window, then the
+ * statistics kernel on the last test's samples. Run it on builds with
+ * HOT_PATH_RAMFUNC 1 and 0 and compare the reports.
+ *******************************************************************************/
+static void printPlacement(const char* name, uint32_t addr)
+{
+    sprintf(uartBuffer, "  %-20s 0x%06lX %s\r\n", name, (unsigned long)addr,
+            addr >= FLASH_CODE_START ? "flash" : "RAM");
+    UART_writeString(uartBuffer);
+}
+
+static void runBenchmark(void)
+{
+    static bool (* const runTest[NUM_ADCS])(uint16_t) = {
+        runSingleTestADC0, runSingleTestADC1, runSingleTestADC2, runSingleTestADC3
+    };
+    uint32_t frd = HWREG(FLASH0CTRL_BASE + FLASH_O_FRDCNTL);
+    uint32_t intf = HWREG(FLASH0CTRL_BASE + FLASH_O_FRD_INTF_CTRL);
+    uint32_t testCyc[NUM_ADCS];
+    uint32_t t0, cyc, best;
+    WindowStats s;
+    uint16_t a, r;
+
+    UART_writeString("\r\n=== Hot path benchmark ===\r\n");
+    sprintf(uartBuffer, "  Flash: %lu wait states, prefetch %s, data cache %s\r\n",
+            (unsigned long)((frd & FLASH_FRDCNTL_RWAIT_M) >> FLASH_FRDCNTL_RWAIT_S),
+            (intf & FLASH_FRD_INTF_CTRL_PREFETCH_EN) ? "on" : "off",
+            (intf & FLASH_FRD_INTF_CTRL_DATA_CACHE_EN) ? "on" : "off");
+    UART_writeString(uartBuffer);
+#if ACQ_MODE == ACQ_MODE_PER_SOC
+    printPlacement("INT_myADC0_1_ISR", (uint32_t)&INT_myADC0_1_ISR);
+    printPlacement("pollChannel", (uint32_t)&pollChannel);
+#else
+    printPlacement("INT_myADC0_EOS_ISR", (uint32_t)&INT_myADC0_EOS_ISR);
+    printPlacement("acquireEOS", (uint32_t)&acquireEOS);
+#endif
+    printPlacement("calculateStatistics", (uint32_t)&calculateStatistics);
+
+    stopEPWMs();
+    resetLatencyStats();
+    resetDropStats();
+    resetRateStats();
+    setAcquisitionWindowADC0(sweepCfg.winStart);
+    setAcquisitionWindowADC1(sweepCfg.winStart);
+    setAcquisitionWindowADC2(sweepCfg.winStart);
+    setAcquisitionWindowADC3(sweepCfg.winStart);
+    delayMs(10);
+
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        t0 = CYCLE_NOW();
+        testCyc[a] = runTest[a](0) ? t0 - CYCLE_NOW() : 0;
+        delayMs(20);
+    }
+    stopEPWMs();
+
+    /* adcResults[] still hold the ADC3 test */
+    best = 0xFFFFFFFFUL;
+    for(r = 0; r < BENCH_REPS; r++)
+    {
+        t0 = CYCLE_NOW();
+        calculateStatistics(adcResults[0], &s);
+        cyc = t0 - CYCLE_NOW();
+        if(cyc < best) best = cyc;
+    }
+
+    displayLatencyStats();
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        if(testCyc[a] == 0)
+            sprintf(uartBuffer, "  ADC%u test failed\r\n", a);
+        else
+            sprintf(uartBuffer, "  ADC%u test %7lu us  (%u ch x %u samples, pause %u us)\r\n", a,
+                    (unsigned long)(testCyc[a] / (DEVICE_SYSCLK_FREQ / 1000000UL)),
+                    adcPaths[a].numCh, sweepCfg.samples, sweepCfg.delayUs);
+        UART_writeString(uartBuffer);
+    }
+    sprintf(uartBuffer, "  calculateStatistics %lu cyc for %u samples\r\n",
+            (unsigned long)best, sweepCfg.samples);
+    UART_writeString(uartBuffer);
+}
+
+/********************************************************************************
+ * Sweep - both phases from (startPhase, startWindow, startTest); false if
+ * the run was aborted from the terminal
+ *******************************************************************************/
+static bool runPhases(uint16_t startPhase, uint16_t startWindow, uint16_t startTest)
+{
+    /* PHASE 1 - Original interleaved pattern maintained */
+    if(startPhase == 0)
+    {
+        if(!runPhase(0, startWindow, startTest)) return false;
+        startWindow = 0;
+        startTest = 0;
+    }
+
+    /* PHASE 2 */
+    delayMs(500);
+    UART_writeString("\r\n===========PHASE 2 Of the TEST...============\r\n\r\n");
+    if(!runPhase(1, startWindow, startTest)) return false;
 
+    clearCheckpoint();
     GPIO_writePin(myBoardLED0_GPIO, 1);
+    return true;
+}
+
+static bool runSweep(uint16_t startPhase, uint16_t startWindow, uint16_t startTest)
+{
+    uint16_t a;
+    bool done;
+
+    allocSampleBuffers();
+    resetEventLog();
+    UART_writeString("Starting sweep: ADC0(3ch) + ADC1(3ch) + ADC2(2ch) + ADC3(4ch)\r\n");
+    sprintf(uartBuffer, "Windows %u..%u step %u, %u tests x %u samples, %u us, masks",
+            sweepCfg.winStart, sweepCfg.winEnd, sweepCfg.winStep,
+            sweepCfg.tests, sweepCfg.samples, sweepCfg.delayUs);
+    UART_writeString(uartBuffer);
+    for(a = 0; a < NUM_ADCS; a++)
+    {
+        sprintf(uartBuffer, " %X", sweepCfg.chanMask[a]);
+        UART_writeString(uartBuffer);
+    }
+    UART_writeString("\r\n");
+#if OS_DETECT
+    detectOpenShort();
+#endif
+    /* The pre-pass thresholds are 12-bit - switch after it */
+    if(sweepCfg.resolution == ADC_RESOLUTION_16BIT)
+    {
+        configureConverters(ADC_CLK_DIV_4_0, ADC_RESOLUTION_16BIT, ADC_MODE_DIFFERENTIAL);
+        UART_writeString("Resolution: 16-bit differential, pairs ADCINn/n+1 (n even) - odd pins not swept\r\n");
+    }
+    else
+        UART_writeString("Resolution: 12-bit single-ended\r\n");
+#if STIM_DAC
+    sprintf(uartBuffer, "Stimulus: on-chip DAC %u -> %u counts on EPWM1A edges (ADCINA0/A1/B1)\r\n",
+            (uint16_t)STIM_LO_CODE, (uint16_t)STIM_HI_CODE);
+    UART_writeString(uartBuffer);
+#else
+    UART_writeString("Stimulus: external wire from GPIO0 (EPWM1A)\r\n");
+#endif
+#if ACQ_MODE == ACQ_MODE_OVERSAMPLE
+    sprintf(uartBuffer, "Acquisition: oversampled x%u (1 ISR per ADC round)\r\n",
+            (uint16_t)OVERSAMPLE_FACTOR);
+    UART_writeString(uartBuffer);
+#elif ACQ_MODE == ACQ_MODE_EOS
+    UART_writeString("Acquisition: end-of-sequence (1 ISR per ADC round)\r\n");
+#else
+    UART_writeString("Acquisition: per-SOC (1 ISR per sample)\r\n");
+#endif
+#if ADC_EARLY_INT
+    sprintf(uartBuffer, "Interrupt: end of S+H window, result hold-off %u cycles\r\n",
+            adcEarlyIntOffset);
+    UART_writeString(uartBuffer);
+#else
+    UART_writeString("Interrupt: end of conversion\r\n");
+#endif
+    UART_writeString("Press A or ESC to abort\r\n");
+    UART_writeString("========================================================\r\n");
+
+    done = runPhases(startPhase, startWindow, startTest);
+
+    /* Scope, coherent average and pre-pass expect the board.c setup */
+    if(sweepCfg.resolution == ADC_RESOLUTION_16BIT)
+        configureConverters(ADC_CLK_DIV_4_0, ADC_RESOLUTION_12BIT, ADC_MODE_SINGLE_ENDED);
+    return done;
+}
 
-    while(1) { /* done */ }
+/********************************************************************************
+ * main - MAINTAINS ORIGINAL INTERLEAVED TEST FLOW
+ *******************************************************************************/
+void main(void)
+{
+    Device_init();
+    Device_initGPIO();
+    Interrupt_initModule();
+    Interrupt_initVectorTable();
+    Board_init();
+
+    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+
+    initCycleTimer();
+    initScheduler();
+    configureInterruptPulse();
+    allocSampleBuffers();
+    resetEventLog();
+
+#if ACQ_MODE != ACQ_MODE_PER_SOC
+    configureEosMode();
+#endif
+#if PPB_DELAY_MONITOR
+    configurePPBDelay();
+#endif
+#if LIMIT_MONITOR
+    configureLimitMonitor();
+#endif
+#if SKEW_MONITOR
+    initSkewMonitor();
+#endif
+#if STIM_DAC
+    initStimulus();
+#endif
+
+    EINT;
+    ERTM;
+
+    delayMs(500);
+
+    for(;;)
+    {
+        uint16_t cmd = runShell();
+        if(cmd == SHELL_RESUME)
+        {
+            sweepCfg = sweepCheckpoint.cfg;
+            runSweep(sweepCheckpoint.phase, sweepCheckpoint.window, sweepCheckpoint.test);
+        }
+        else if(cmd == SHELL_GRID)
+        {
+            /* The grid reuses window 0 of the result arrays */
+            clearCheckpoint();
+            runGridSweep();
+        }
+        else if(cmd == SHELL_RATE)
+        {
+            clearCheckpoint();
+            runRateSweep();
+        }
+        else if(cmd == SHELL_BENCH)
+        {
+            /* The benchmark overwrites test 0 of the result arrays */
+            clearCheckpoint();
+            runBenchmark();
+        }
+        else
+        {
+            clearCheckpoint();
+            runSweep(0, 0, 0);
+        }
+    }
 }
 
 /* EOF */
@@ -9,12 +9,16 @@
 #include "board.h"
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stdbool.h>
 
 /*********************************************************************************
  * Defines
  *********************************************************************************/
-#define RESULTS_BUFFER_SIZE     50
+/* Power-up sweep settings - the UART shell changes them per run. The
+ * TESTS_PER_WINDOW and NUM_WINDOWS values also size the result arrays, so
+ * they are the upper limits of the shell's "tests" and "win" commands. */
+#define RESULTS_BUFFER_SIZE     50      /* Samples per test */
 #define TESTS_PER_WINDOW        50
 #define SAMPLE_DELAY_US         200
 
@@ -22,27 +26,456 @@
 #define ACQ_WINDOW_END          20
 #define NUM_WINDOWS             (ACQ_WINDOW_END - ACQ_WINDOW_START + 1)
 
+/* Per-channel sample buffers are carved out of one static pool at run start */
+#define SAMPLE_POOL_WORDS       2048
+#define MAX_SAMPLES_PER_TEST    (SAMPLE_POOL_WORDS / MAX_CHANNELS)
+#define ACQ_WINDOW_MAX          512     /* ACQPS is 9 bits */
+
+/* Final table format */
+#define OUTPUT_TABLE            0
+#define OUTPUT_CSV              1
+
+/* UART shell */
+#define SHELL_LINE_MAX          64
+#define SHELL_RUN               0
+#define SHELL_RESUME            1
+#define SHELL_GRID              2
+#define SHELL_RATE              3
+#define SHELL_BENCH             4
+
 #define TIMEOUT_CYCLES          1000000
+#define TEST_MAX_RETRIES        2   /* Re-runs of a timed-out test before it is marked invalid */
+
+/* Sweep checkpoint - tag changes whenever the result layout does */
+#define CHECKPOINT_MAGIC        0x5358u   /* Bumped with the result store layout */
+#define CHECKPOINT_TAG          ((ACQ_MODE << 12) | (NUM_WINDOWS << 6) | TESTS_PER_WINDOW)
 
 #define MAX_CHANNELS            4  /* Maximum channels for shared runtime arrays */
 
+/* calculateStatistics sums a test in 32 bits and its squares in 64 bits;
+ * n * sum(x^2) << VAR_FRAC_BITS must fit for 16-bit results */
+#if MAX_SAMPLES_PER_TEST > 4095
+#error "MAX_SAMPLES_PER_TEST too large for the 64-bit variance sum"
+#endif
+
 #define ADC0_NUM_CH     3
 #define ADC1_NUM_CH     3
 #define ADC2_NUM_CH     2
 #define ADC3_NUM_CH     4
 
+/* Result store rows - every tested channel of ADC0..ADC3 in order */
+#define RES_NUM_ROWS        (ADC0_NUM_CH + ADC1_NUM_CH + ADC2_NUM_CH + ADC3_NUM_CH)
+#define RES_ROW(adc, ch)    (resRowBase[(adc)] + (ch))
+#define RES_VALID_WORDS(n)  (((n) + 15U) / 16U)
+#define VAR_FRAC_BITS       8       /* Variance fraction bits */
+
+#define NUM_ADCS        4
+
+/* Acquisition modes */
+#define ACQ_MODE_PER_SOC        0  /* One ADCINT per SOC - one ISR entry per sample */
+#define ACQ_MODE_EOS            1  /* SOCs chained round-robin - one ADCINT per ADC round */
+#define ACQ_MODE_OVERSAMPLE     2  /* N SOCs per pin, converted back-to-back, decimated in the ISR */
+
+#ifndef ACQ_MODE
+#define ACQ_MODE                ACQ_MODE_PER_SOC
+#endif
+
+/* Oversampling - each channel owns OVERSAMPLE_FACTOR consecutive SOCs */
+#define OVERSAMPLE_FACTOR       4
+#define ADC_NUM_SOCS            16
+
+#if (ACQ_MODE == ACQ_MODE_OVERSAMPLE) && (OVERSAMPLE_FACTOR * MAX_CHANNELS > ADC_NUM_SOCS)
+#error "OVERSAMPLE_FACTOR too large - the widest ADC would need more than 16 SOCs"
+#endif
+
+#define NUM_PHASES      2
+
+/* Early interrupt - ADCINT pulses at the end of the S+H window so ISR entry
+ * overlaps the conversion. F2837xD has no ADCINTCYCLE register, so the ISR
+ * holds off ADC_EARLY_INT_OFFSET SYSCLK cycles from its first instruction
+ * (software interrupt cycle offset) before reading the result. */
+#ifndef ADC_EARLY_INT
+#define ADC_EARLY_INT           0       /* Opt-in: the hold-off is an estimate, not a latch check */
+#endif
+#define ADC_CONV_SYSCLK         44  /* 12-bit: 10.5 ADCCLK @ SYSCLK/4 + result latch */
+#define ADC_LATCH_SYSCLK        2   /* Result latch after the last ADCCLK */
+#define ISR_ENTRY_CYCLES        14  /* PIE -> first ISR instruction, C28x with FPU context save */
+#define ADC_EARLY_INT_OFFSET    (ADC_CONV_SYSCLK - ISR_ENTRY_CYCLES)   /* Power-up; configureConverters recomputes */
+
+/* Free-running SYSCLK timestamp counter (counts down) */
+#define CYCLE_TIMER_BASE        CPUTIMER1_BASE
+
+/* Cooperative scheduler - settling waits and the shell prompt hand their
+ * time to background tasks, paced off CYCLE_TIMER_BASE. UART output is
+ * queued in a transmit ring that a task feeds to the SCI FIFO, so window
+ * reports and the event log go out during the next settling waits instead
+ * of stalling the sweep. The sweep itself stays a sequential loop and the
+ * statistics stay inline: the next test reuses the shared sample buffers.
+ * No interrupt of its own, so ISR latency and skew figures are unaffected. */
+#ifndef TASK_SCHEDULER
+#define TASK_SCHEDULER          1
+#endif
+#define SCHED_CYCLES_PER_MS     (DEVICE_SYSCLK_FREQ / 1000UL)
+#define UART_TX_SIZE            1024    /* Transmit ring, power of two */
+#if (UART_TX_SIZE & (UART_TX_SIZE - 1)) != 0
+#error "UART_TX_SIZE must be a power of two"
+#endif
+#define HEARTBEAT_GPIO          31      /* controlCARD LED D1; myBoardLED0 marks acquisition */
+#define GPIO_PIN_MUX(n)         GPIO_PIN_MUX_(n)
+#define GPIO_PIN_MUX_(n)        GPIO_##n##_GPIO##n      /* pin_map.h GPIO mux name */
+#define HEARTBEAT_MS            500U
+
+/* Hot path placement - ISRs, the polling loops and the statistics kernels
+ * link into .TI.ramfunc, which Device_init copies from flash to RAMLS0_2
+ * (zero wait states) before Flash_initModule sets DEVICE_FLASH_WAITSTATES
+ * and enables prefetch and the data cache. 0 runs them from flash, for
+ * comparing with the 'bench' command. */
+#ifndef HOT_PATH_RAMFUNC
+#define HOT_PATH_RAMFUNC        1
+#endif
+#if HOT_PATH_RAMFUNC && defined(__TI_COMPILER_VERSION__)
+#define RAMFUNC                 __attribute__((ramfunc))
+#else
+#define RAMFUNC
+#endif
+#define FLASH_CODE_START        0x080000UL  /* Bank 0 sector A */
+#define BENCH_REPS              8           /* Statistics kernel runs, fastest kept */
+
+/* ePWM skew monitor - eCAP1 timestamps EPWM1A as reference, eCAP2-6 the
+ * other EPWMxA outputs (two groups cover EPWM2-8) after each startPWM */
+#ifndef SKEW_MONITOR
+#define SKEW_MONITOR            1
+#endif
+#define NUM_EPWMS               8
+#define NUM_ECAPS               6
+#define SKEW_EDGES              4   /* Rising edges timestamped per module per restart */
+#define SKEW_RESTARTS           4   /* Restarts measured at the start of each window */
+#define SKEW_TIMEOUT_US         5000
+
+/* Trigger-to-conversion delay - PPBn is attached to the first SOC of ch n-1
+ * and its delay stamp is read with every result */
+#ifndef PPB_DELAY_MONITOR
+#define PPB_DELAY_MONITOR       1
+#endif
+#define DELAY_HIST_BINS         8
+#define DELAY_BIN_CYCLES        32  /* SYSCLK cycles per histogram bin, last bin open-ended */
+
+/* Hardware limit monitor - the same PPBs compare every result against
+ * LIMIT_HI/LO_COUNTS. Armed high first, then low, so each logged event is a
+ * crossing (Schmitt style), timestamped with the EPWM1 counter. */
+#ifndef LIMIT_MONITOR
+#define LIMIT_MONITOR           1
+#endif
+#define LIMIT_HI_COUNTS         3686    /* 90% of 4095 */
+#define LIMIT_LO_COUNTS         410     /* 10% of 4095 */
+#define LIMIT_LOG_SIZE          64      /* Events kept per window */
+#define LIMIT_PRINT_EVENTS      8       /* Events listed in the window report */
+
+/* Scope capture - one pin converted back-to-back (ADC continuous mode on
+ * ADCINT1), DMA CH1 circling through a RAMGS6-11 buffer. A rising crossing
+ * of SCOPE_TRIG_LEVEL on the PPB freezes SCOPE_POST samples later. */
+#define SCOPE_DEPTH             24576   /* Words - RAMGS6..RAMGS11 */
+#define SCOPE_PRE               1024    /* Samples kept before the trigger */
+#define SCOPE_POST              3072    /* Samples kept after the trigger */
+#define SCOPE_TRIG_LEVEL        2048
+#define SCOPE_TRIG_HYST         64      /* Must go below LEVEL-HYST before arming */
+#define SCOPE_ACQ_CYCLES        15
+#define SCOPE_SOC               ADC_SOC_NUMBER15
+#define SCOPE_PPB               ADC_PPB_NUMBER4
+#define SCOPE_DMA_BASE          DMA_CH1_BASE
+#define SCOPE_TIMEOUT_MS        2000
+#define SCOPE_ADC               0       /* Default target: ADC0 ch0, Phase 1 pin */
+#define SCOPE_CH                0
+
+#if (SCOPE_PRE + SCOPE_POST) > SCOPE_DEPTH
+#error "SCOPE_PRE + SCOPE_POST must fit in SCOPE_DEPTH"
+#endif
+
+/* Coherent averaging - every shot of COH_BINS back-to-back samples starts on
+ * ePWM8 SOCA at CMPC, COH_PRE_TBCLK ahead of the EPWM1A rising edge. ePWM8
+ * paces no sweep SOC, so its SOCA and CMPC are free to borrow. */
+#define COH_BINS                512
+#define COH_REPS                256     /* Shots summed per channel (<= 65535) */
+#define COH_FRAC_BITS           4       /* Sub-LSB bits kept in cohWave */
+#define COH_PRE_TBCLK           1000    /* TBCLK = SYSCLK/4 -> 20 us before the edge */
+#define COH_TRIG_EPWM           myEPWM7_BASE
+#define COH_ADC_TRIGGER         ADC_TRIGGER_EPWM8_SOCA
+#define COH_EST_KSPS            3500    /* Edge-bin estimate until a scope run measures it */
+
+#if COH_BINS > SCOPE_DEPTH
+#error "COH_BINS must fit in the scope buffer"
+#endif
+
+/* DAC step stimulus - DACA/B/C sit on ADCINA0, ADCINA1 and ADCINB1, so the
+ * DAC steps straight into ADC0 ch0 (both phases) and ADC1 ch0 (Phase 2).
+ * Values load on ePWM9 PWMSYNC; ePWM9 counts up with half the EPWM1 cycle,
+ * offset so its zero lands on both EPWM1A edges. ADCD has no DAC pin.
+ * Off by default - the DACs would fight the external GPIO0 wire. */
+#ifndef STIM_DAC
+#define STIM_DAC                0
+#endif
+#define STIM_DAC_MASK           0x7     /* bit0 DACA, bit1 DACB, bit2 DACC */
+#define STIM_LO_CODE            410     /* 10% of VREFHI */
+#define STIM_HI_CODE            3686    /* 90% of VREFHI */
+#define STIM_EPWM_BASE          EPWM9_BASE
+#define STIM_EPWM_NUM           9
+#define STIM_EPWM_PERIOD        25000   /* TBCLK per half EPWM1 cycle (up-down 2 x 25000) */
+#define STIM_EPWM_OFFSET        12500   /* EPWM1 CMPA - first zero on the rising edge */
+
+/* Deferred event log - fixed-size binary records written during the run
+ * and formatted only between windows or from the shell. Records carry a
+ * level; printing keeps those at or below the selected verbosity. */
+#ifndef EVENT_LOG
+#define EVENT_LOG               1
+#endif
+#define LOG_SIZE                256     /* Records kept, power of two */
+#define LOG_LEVEL_ERROR         0       /* Failed test attempts */
+#define LOG_LEVEL_WINDOW        1       /* Per-window channel averages */
+#define LOG_LEVEL_TEST          2       /* Every test of every channel */
+#define LOG_VERBOSITY           LOG_LEVEL_WINDOW
+
+#if (LOG_SIZE & (LOG_SIZE - 1)) != 0
+#error "LOG_SIZE must be a power of two"
+#endif
+
+/* Crosstalk matrix - needs STIM_DAC. Each DAC in turn steps while all four
+ * ADCs sample one pin each from the same ePWM8 SOCA (COH_ADC_TRIGGER). */
+#define XTALK_NUM_AGGR          3       /* DACA, DACB, DACC */
+#define XTALK_ROUNDS            64      /* Per aggressor and victim set, half low, half high */
+#define XTALK_EDGE_US           2       /* Aggressor step to the shared trigger */
+#define XTALK_SPACING_US        10      /* > one conversion at the longest window */
+
+/* Open/short pre-pass - every tested pin of both phases is sampled plain,
+ * with the 5K pull-down and with the 5K pull-up (ADC OSDETECT). A pin that
+ * follows the pulls is open; one stuck at a rail is shorted. Either is
+ * dropped from that phase's sweep schedule. */
+#ifndef OS_DETECT
+#define OS_DETECT               1
+#endif
+#define OS_SAMPLES              32
+#define OS_SAMPLE_SPACING_US    50      /* 32 x 50 us spans > 1 EPWM1 cycle */
+#define OS_ACQ_CYCLES           200     /* 1 us - lets the 5K pull charge the S+H */
+#define OS_PULL_DELTA           1500    /* Pull-up minus pull-down counts => open */
+#define OS_RAIL_COUNTS          40      /* Within this of 0 / 4095 => at a rail */
+#define OS_STUCK_RANGE          8       /* Max-min at or below this => not moving */
+
+/* Channel-order scan - SOC14 converts the preceding pin (another tested pin
+ * or ORDER_DUMMY_PIN) and SOC15 the measured pin, forced back-to-back in
+ * round-robin order with the PWMs stopped so every pin sits at DC. A pair's
+ * error is the measured pin's mean after that predecessor minus its mean
+ * after itself: the charge the S+H carried over. */
+#define ORDER_PREV_SOC          ADC_SOC_NUMBER14
+#define ORDER_MEAS_SOC          ADC_SOC_NUMBER15
+#define ORDER_SAMPLES           32
+#define ORDER_SPACING_US        10      /* > two conversions at the longest window */
+#define ORDER_DUMMY_PIN         ADC_CH_ADCIN13  /* Wire to VREFLO, or name any quiet pin */
+#define ORDER_ERR_TOL_X100      50      /* Settled: |error| <= 0.50 LSB */
+#define ORDER_DUMMY             MAX_CHANNELS    /* Predecessor index of the dummy pin */
+
+/* Grid sweep - acquisition window x ADC clock divider x resolution/mode.
+ * The window axis is the shell's win range; each supported combination is
+ * one cell of sweepCfg.tests tests, averaged into gridCells[]. F2837xD
+ * converts single-ended at 12 bits and differential at 16 bits only, so the
+ * other two combinations are skipped. */
+#define GRID_MAX_CELLS          96
+#define GRID_NUM_DIVS           4
+#define GRID_DIVS               { ADC_CLK_DIV_4_0, ADC_CLK_DIV_5_0, ADC_CLK_DIV_6_0, ADC_CLK_DIV_8_0 }
+#define GRID_MIN_DIV            ADC_CLK_DIV_4_0 /* ADCCLK <= 50 MHz at SYSCLK 200 MHz */
+#define GRID_STD_TARGET_X100    150     /* Accuracy target: std dev <= 1.50 LSB, 12-bit scale */
+#define ADC_MIN_ACQ_12BIT       15      /* 75 ns S+H */
+#define ADC_MIN_ACQ_16BIT       64      /* 320 ns S+H */
+#define ADC_CONV_X4_12BIT       42      /* Conversion 10.5 ADCCLK, x4 */
+#define ADC_CONV_X4_16BIT       118     /* Conversion 29.5 ADCCLK, x4 */
+
+/* Sample-rate sweep - the pause between sample rounds is the swept axis at
+ * one window, down to 0 (rounds forced back-to-back). The ISRs timestamp
+ * every result with CYCLE_NOW, giving the achieved rate per ADC. A step is
+ * flagged once a channel's mean moves by more than RATE_AVG_TOL, or its
+ * std dev grows by more than RATE_STD_TOL_X100, against the slowest step. */
+#define RATE_NUM_STEPS          9
+#define RATE_DELAYS_US          { 200, 100, 50, 20, 10, 5, 2, 1, 0 }
+#define RATE_AVG_TOL            4       /* LSB */
+#define RATE_STD_TOL_X100       50      /* 0.50 LSB */
+
 /*********************************************************************************
  * Typedefs
  *********************************************************************************/
+/* One test's statistics, or one window's averages, unpacked from the
+ * result store. range is max - min. */
 typedef struct {
-    uint16_t windowCycles;
     uint16_t min;
     uint16_t max;
     uint16_t avg;
     uint16_t range;
-    float    stdDev;
+    uint32_t var;       /* Population variance, counts^2 with VAR_FRAC_BITS fraction bits */
+    bool     valid;     /* false - every attempt timed out / no valid test in the window */
 } WindowStats;
 
+/* Result store - structure of arrays. Rows are the tested channels of all
+ * four ADCs in order (RES_ROW), columns are tests or windows, so each field
+ * of one channel is contiguous. valid holds one bit per column. */
+typedef struct {
+    uint16_t min[RES_NUM_ROWS][TESTS_PER_WINDOW];
+    uint16_t max[RES_NUM_ROWS][TESTS_PER_WINDOW];
+    uint16_t avg[RES_NUM_ROWS][TESTS_PER_WINDOW];
+    uint32_t var[RES_NUM_ROWS][TESTS_PER_WINDOW];
+    uint16_t valid[RES_NUM_ROWS][RES_VALID_WORDS(TESTS_PER_WINDOW)];
+} TestStore;
+
+/* Window averages; var is the mean test variance */
+typedef struct {
+    uint16_t min[RES_NUM_ROWS][NUM_WINDOWS];
+    uint16_t max[RES_NUM_ROWS][NUM_WINDOWS];
+    uint16_t avg[RES_NUM_ROWS][NUM_WINDOWS];
+    uint32_t var[RES_NUM_ROWS][NUM_WINDOWS];
+    uint16_t valid[RES_NUM_ROWS][RES_VALID_WORDS(NUM_WINDOWS)];
+} WindowStore;
+
+/* Force-to-ISR / force-to-result latencies in SYSCLK cycles */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint16_t count;
+} LatencyStats;
+
+/* Per-channel lost-sample accounting for the current window */
+typedef struct {
+    uint32_t samples;   /* Results actually read by an ISR */
+    uint16_t overflow;  /* ADCSOCOVF - SOC re-triggered while still pending, conversion dropped */
+    uint16_t late;      /* ADCINTOVF - EOC while ADCINT still set, result overwritten before read */
+    uint16_t timeout;   /* No result within TIMEOUT_CYCLES */
+} DropStats;
+
+/* Result spacing on one ADC for the current window, SYSCLK cycles */
+typedef struct {
+    uint32_t lastStamp;
+    uint32_t cycles;        /* Sum of gaps between consecutive interrupts */
+    uint32_t conversions;   /* Conversions delivered across those gaps */
+    uint32_t gaps;
+    uint32_t minGap;
+    uint32_t maxGap;
+    bool     armed;         /* lastStamp valid - cleared at each test start */
+} RateStats;
+
+/* PPB delay stamp distribution for one channel, SYSCLK cycles */
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint16_t count;
+    uint16_t bin[DELAY_HIST_BINS];
+} DelayStats;
+
+/* One PPB limit crossing */
+typedef struct {
+    uint32_t cycle;     /* CYCLE_TIMER_BASE count (counts down) */
+    uint16_t tbctr;     /* EPWM1 time-base counter at the event */
+    uint16_t adc;
+    uint16_t ch;
+    uint16_t flags;     /* ADC_EVT_TRIPHI / ADC_EVT_TRIPLO, bit 15 = EPWM1 counting down */
+} LimitEvent;
+
+/* One background task - run when periodMs has passed since it last ran,
+ * or on every yield when periodMs is 0 */
+typedef struct {
+    void     (*run)(void);
+    uint16_t periodMs;
+    uint32_t last;      /* CYCLE_TIMER_BASE count at the last run */
+} SchedTask;
+
+/* Edge skew of one EPWMxA against EPWM1A, SYSCLK cycles */
+typedef struct {
+    int32_t  min;       /* First edge after startPWM */
+    int32_t  max;
+    int32_t  sum;
+    int32_t  driftMax;  /* Largest |skew(last edge) - skew(first edge)| */
+    uint16_t count;
+    uint16_t missed;    /* Restarts where this output produced no edges */
+} SkewStats;
+
+/* Run settings, set through the UART shell */
+typedef struct {
+    uint16_t winStart;              /* First acquisition window, SYSCLK cycles */
+    uint16_t winEnd;
+    uint16_t winStep;
+    uint16_t tests;                 /* Tests per window, <= TESTS_PER_WINDOW */
+    uint16_t samples;               /* Samples per test, <= MAX_SAMPLES_PER_TEST */
+    uint16_t delayUs;               /* Pause between sample rounds */
+    uint16_t chanMask[NUM_ADCS];    /* Bit ch set = channel swept */
+    uint16_t format;                /* OUTPUT_TABLE / OUTPUT_CSV */
+    uint16_t resolution;            /* ADC_RESOLUTION_12BIT single-ended / _16BIT differential */
+} SweepConfig;
+
+/* Sweep progress - lives in NOINIT RAM next to the results it describes, so it
+ * survives XRSn / watchdog / debugger resets (not power loss) */
+typedef struct {
+    uint16_t magic;
+    uint16_t tag;
+    uint16_t phase;     /* 0 = Phase 1, 1 = Phase 2 */
+    uint16_t window;    /* Window index to resume */
+    uint16_t test;      /* Next test within that window */
+    SweepConfig cfg;    /* Settings the interrupted run was started with */
+    uint16_t checksum;
+} SweepCheckpoint;
+
+/* One grid sweep setting */
+typedef struct {
+    uint16_t window;        /* S+H, SYSCLK cycles */
+    uint16_t prescale;      /* ADC_ClkPrescale */
+    uint16_t resolution;    /* ADC_Resolution */
+    uint16_t mode;          /* ADC_SignalMode */
+} GridPoint;
+
+/* Grid cell result - averages of the cell's valid tests [adc][ch] */
+typedef struct {
+    GridPoint pt;
+    uint16_t  avg[NUM_ADCS][MAX_CHANNELS];
+    uint16_t  range[NUM_ADCS][MAX_CHANNELS];
+    uint16_t  stdX100[NUM_ADCS][MAX_CHANNELS];  /* LSB of the cell's resolution x 100 */
+    uint16_t  validMask[NUM_ADCS];
+} GridCell;
+
+/* Event log record kinds */
+typedef enum {
+    LOG_TEST = 0,       /* One test of one channel */
+    LOG_WINDOW,         /* Window average of one channel */
+    LOG_RETRY           /* Test attempt timed out - ch byte holds the attempt */
+} LogKind;
+
+/* One event log record - 12 words, no padding */
+typedef struct {
+    uint32_t stamp;     /* CYCLE_NOW at the write (counts down) */
+    uint16_t wraps;     /* Cycle counter reloads before stamp */
+    uint16_t kind;      /* LogKind */
+    uint16_t src;       /* adc << 8 | ch */
+    uint16_t window;    /* Acquisition window, SYSCLK cycles */
+    uint16_t test;
+    uint16_t min;
+    uint16_t max;
+    uint16_t avg;
+    uint16_t range;
+    uint16_t stdX100;
+} LogRecord;
+
+/* Open/short pre-pass result for one pin */
+typedef enum {
+    CH_CONNECTED = 0,
+    CH_OPEN,
+    CH_SHORTED
+} ChannelState;
+
+/* Static description of one ADC's tested SOCs, used by the generic acquisition paths */
+typedef struct {
+    uint32_t       base;
+    uint32_t       resultBase;
+    uint32_t       pieInt;          /* ADCINT1 vector - reused as the end-of-sequence interrupt */
+    uint16_t       ackGroup;
+    uint16_t       numCh;
+    ADC_SOCNumber  soc[MAX_CHANNELS];
+    ADC_Channel    phaseCh[NUM_PHASES][MAX_CHANNELS];  /* Pin per ch for Phase 1 / Phase 2 */
+} AdcPath;
+
 /*********************************************************************************
  * Extern Variable Declarations - HYBRID APPROACH
  * 
@@ -51,21 +484,75 @@ typedef struct {
  *********************************************************************************/
 
 /* LEVEL 1: Shared volatile arrays - REUSED by all ADCs during sampling */
-extern volatile uint16_t adcResults[MAX_CHANNELS][RESULTS_BUFFER_SIZE];
+extern volatile uint16_t* adcResults[MAX_CHANNELS];   /* sweepCfg.samples each, from the pool */
 extern volatile uint16_t adcIndex[MAX_CHANNELS];
 extern volatile uint16_t adcSampleCount[MAX_CHANNELS];
 extern volatile uint16_t adcComplete[MAX_CHANNELS];
 
-/* LEVEL 2: Persistent storage - SEPARATE for each ADC */
-extern WindowStats adc0TestResults[ADC0_NUM_CH][TESTS_PER_WINDOW];
-extern WindowStats adc1TestResults[ADC1_NUM_CH][TESTS_PER_WINDOW];
-extern WindowStats adc2TestResults[ADC2_NUM_CH][TESTS_PER_WINDOW];
-extern WindowStats adc3TestResults[ADC3_NUM_CH][TESTS_PER_WINDOW];
+/* LEVEL 2: Persistent storage - one store for all ADCs, rows by RES_ROW */
+extern TestStore testStore;
+extern WindowStore windowStore;
+extern const uint16_t resRowBase[NUM_ADCS];
+
+/* Per-ADC SOC layout [ADC0..ADC3] */
+extern const AdcPath adcPaths[NUM_ADCS];
+
+/* Latency measurements for the current window [ADC0..ADC3] */
+extern LatencyStats isrEntryLatency[NUM_ADCS];
+extern LatencyStats turnaroundLatency[NUM_ADCS];
+extern volatile uint32_t isrEntryStamp;
+
+/* Lost-sample accounting for the current window [adc][ch] */
+extern volatile DropStats adcDropStats[NUM_ADCS][MAX_CHANNELS];
+
+/* Achieved sample rate for the current window [ADC0..ADC3] */
+extern volatile RateStats adcRate[NUM_ADCS];
+
+/* Sweep progress / settings */
+extern SweepCheckpoint sweepCheckpoint;
+extern SweepConfig sweepCfg;
+
+/* Trigger-to-conversion delay for the current window [adc][ch] */
+extern volatile DelayStats adcDelayStats[NUM_ADCS][MAX_CHANNELS];
+
+/* Limit crossings for the current window */
+extern volatile LimitEvent limitLog[LIMIT_LOG_SIZE];
+extern volatile uint16_t limitLogCount;
+extern volatile uint16_t limitHiCount[NUM_ADCS][MAX_CHANNELS];
+extern volatile uint16_t limitLoCount[NUM_ADCS][MAX_CHANNELS];
 
-extern WindowStats adc0WindowResults[ADC0_NUM_CH][NUM_WINDOWS];
-extern WindowStats adc1WindowResults[ADC1_NUM_CH][NUM_WINDOWS];
-extern WindowStats adc2WindowResults[ADC2_NUM_CH][NUM_WINDOWS];
-extern WindowStats adc3WindowResults[ADC3_NUM_CH][NUM_WINDOWS];
+/* Scope capture */
+extern uint16_t scopeBuffer[SCOPE_DEPTH];
+extern uint16_t scopeTrigIndex;
+extern uint32_t scopeRateKsps;
+extern uint16_t cohWave[MAX_CHANNELS][COH_BINS];   /* Averaged LSB << COH_FRAC_BITS */
+
+/* DAC step stimulus - steps issued since startPWM */
+extern volatile uint32_t stimSteps;
+
+/* Sweep schedule - bit ch set = channel tested [phase][adc] */
+extern uint16_t chanActive[NUM_PHASES][NUM_ADCS];
+extern ChannelState chanState[NUM_PHASES][NUM_ADCS][MAX_CHANNELS];
+
+/* Channel-order scan of one ADC - error x 100 LSB [window][prev][measured] */
+extern int16_t orderErr[NUM_WINDOWS][MAX_CHANNELS + 1][MAX_CHANNELS];
+
+/* Crosstalk - victim high-minus-low mean x 100 LSB [window][DAC][adc][ch],
+ * and each ADC's delay from the shared trigger */
+extern int16_t xtalkErr[NUM_WINDOWS][XTALK_NUM_AGGR][NUM_ADCS][MAX_CHANNELS];
+extern DelayStats xtalkDelay[NUM_ADCS];
+
+/* Event log ring - logHead counts every record ever written */
+extern LogRecord eventLog[LOG_SIZE];
+extern uint32_t logHead;
+extern uint16_t logVerbosity;
+
+/* Grid sweep results, gridNumCells in run order */
+extern GridCell gridCells[GRID_MAX_CELLS];
+extern uint16_t gridNumCells;
+
+/* Skew of EPWM1A..EPWM8A vs EPWM1A for the current window */
+extern SkewStats epwmSkew[NUM_EPWMS];
 
 /* EPWM sync state */
 extern volatile uint16_t systemSynced;
@@ -97,11 +584,96 @@ __interrupt void INT_myADC3_2_ISR(void);
 __interrupt void INT_myADC3_3_ISR(void);
 __interrupt void INT_myADC3_4_ISR(void);
 
+/* ISRs - end-of-sequence mode (one per ADC, on ADCINT1) */
+__interrupt void INT_myADC0_EOS_ISR(void);
+__interrupt void INT_myADC1_EOS_ISR(void);
+__interrupt void INT_myADC2_EOS_ISR(void);
+__interrupt void INT_myADC3_EOS_ISR(void);
+
+/* ISRs - PPB limit events (one per ADC) */
+__interrupt void INT_myADC0_EVT_ISR(void);
+__interrupt void INT_myADC1_EVT_ISR(void);
+__interrupt void INT_myADC2_EVT_ISR(void);
+__interrupt void INT_myADC3_EVT_ISR(void);
+
 /* Control */
 void waitForKeyPress(void);
 void stopEPWMs(void);
 void startPWM(void);
 void delayMs(uint16_t ms);
+void waitUs(uint32_t us);
+void configureEosMode(void);
+void setupOversampleSOCs(const AdcPath* p, uint16_t phase, uint16_t cycles);
+void configureInterruptPulse(void);
+
+/* Cycle timestamps */
+void initCycleTimer(void);
+uint32_t cycleStamp(uint16_t* wraps);
+
+/* Cooperative scheduler */
+void initScheduler(void);
+void schedYield(void);
+void resetLatencyStats(void);
+void recordLatency(LatencyStats* s, uint32_t cycles);
+
+/* Lost-sample accounting */
+void resetDropStats(void);
+
+/* Achieved sample rate */
+void resetRateStats(void);
+uint32_t achievedKsps(uint16_t adc);
+void displayRateStats(void);
+
+/* PPB delay stamps */
+void configurePPBDelay(void);
+void resetDelayStats(void);
+void displayDelayStats(void);
+
+/* PPB limit monitor */
+void configureLimitMonitor(void);
+void resetLimitLog(void);
+void displayLimitLog(void);
+
+/* Scope capture */
+bool runScopeCapture(uint16_t adc, ADC_Channel pin);
+void displayScopeCapture(void);
+bool runCoherentAverage(uint16_t adc, uint16_t phase, uint16_t reps);
+void displayCoherentAverage(void);
+void setSweepADCTriggers(bool enable);
+
+/* DAC step stimulus */
+void initStimulus(void);
+void resetStimulus(void);
+__interrupt void stimulusISR(void);
+
+/* Open/short pre-pass */
+void detectOpenShort(void);
+
+/* Deferred event log */
+void resetEventLog(void);
+void logStats(LogKind kind, uint16_t adc, uint16_t ch, uint16_t window, uint16_t test,
+              const WindowStats* s);
+void drainEventLog(bool all);
+void drainEventLogStep(void);
+
+/* Channel-order scan */
+void runOrderScan(uint16_t adc, uint16_t phase);
+void displayOrderScan(void);
+
+/* Simultaneous crosstalk matrix */
+void runCrosstalk(uint16_t phase);
+void displayCrosstalk(void);
+
+/* Converter setup / grid sweep */
+void configureConverters(ADC_ClkPrescale prescale, ADC_Resolution resolution, ADC_SignalMode mode);
+uint16_t gridSampleCycles(const GridPoint* g);
+void displayGridResults(void);
+
+/* ePWM skew monitor */
+void initSkewMonitor(void);
+void resetSkewStats(void);
+void measureSkew(void);
+void displaySkewStats(void);
 
 /* Acquisition window setters */
 void setAcquisitionWindowADC0(uint16_t cycles);
@@ -115,15 +687,30 @@ void ReconfigureandsetAcquisitionWindowADC1(uint16_t cycles);
 void ReconfigureandsetAcquisitionWindowADC2(uint16_t cycles);
 void ReconfigureandsetAcquisitionWindowADC3(uint16_t cycles);
 
-/* Single test runners */
-void runSingleTestADC0(uint16_t testNumber);
-void runSingleTestADC1(uint16_t testNumber);
-void runSingleTestADC2(uint16_t testNumber);
-void runSingleTestADC3(uint16_t testNumber);
+/* Single test runners - false if the test timed out */
+bool runSingleTestADC0(uint16_t testNumber);
+bool runSingleTestADC1(uint16_t testNumber);
+bool runSingleTestADC2(uint16_t testNumber);
+bool runSingleTestADC3(uint16_t testNumber);
+
+/* Run settings / UART shell */
+uint16_t runShell(void);
+void displayPhaseResults(uint16_t phase);
+uint16_t sweepNumWindows(void);
+uint16_t windowCycles(uint16_t windowIndex);
+
+/* Checkpoint / resume */
+void saveCheckpoint(uint16_t phase, uint16_t window, uint16_t test);
+bool checkpointValid(void);
+void clearCheckpoint(void);
 
 /* Statistics */
 void  calculateStatistics(volatile uint16_t* results, WindowStats* stats);
-float calculateStdDev(volatile uint16_t* results, uint16_t avg);
+uint32_t varStdX100(uint32_t var);
+void  storeTestResult(uint16_t row, uint16_t test, const WindowStats* s);
+void  setTestValid(uint16_t row, uint16_t test, bool valid);
+void  loadTestResult(uint16_t row, uint16_t test, WindowStats* s);
+void  loadWindowResult(uint16_t row, uint16_t w, WindowStats* s);
 void  calculateWindowAverageADC0(uint16_t windowIndex);
 void  calculateWindowAverageADC1(uint16_t windowIndex);
 void  calculateWindowAverageADC2(uint16_t windowIndex);
@@ -131,6 +718,8 @@ void  calculateWindowAverageADC3(uint16_t windowIndex);
 
 /* Display */
 void displayTestResult(uint16_t testNum, const char* label, WindowStats* stats);
+void displayLatencyStats(void);
+void displayDropStats(void);
 void displayFinalTableADC0(void);
 void displayFinalTableADC1(void);
 void displayFinalTableADC2(void);
@@ -138,6 +727,8 @@ void displayFinalTableADC3(void);
 
 /* UART */
 void UART_writeString(const char* str);
+void UART_writeChar(char c);
+bool UART_lineFree(void);
 char UART_readChar(void);
 
 #endif /* Test_0_02_MULTI_ADC_CONFIG_H_ */
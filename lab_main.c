@@ -52,6 +52,7 @@
 #include "driverlib.h"
 #include "device.h"
 #include "board.h"
+#include <math.h>
 
 uint32_t ePwm_TimeBase;
 uint32_t ePwm_MinDuty;
@@ -62,11 +63,102 @@ uint16_t AdcBuf[50];            // Buffer to store ADC samples.
 uint16_t *AdcBufPtr = AdcBuf;   // Pointer to ADC buffer samples.
 uint16_t LedCtr = 0;            // Counter to slow down LED toggle in ADC ISR.
 uint16_t DutyModOn = 0;         // Flag to turn on/off duty cycle modulation.
-uint16_t DutyModDir = 0;        // Flag to control duty mod direction up/down.
-uint16_t DutyModCtr = 0;        // Counter to slow down rate of modulation.
 int32_t eCapPwmDuty;            // Percent = (eCapPwmDuty/eCapPwmPeriod)*100.
 int32_t eCapPwmPeriod;          // Frequency = DEVICE_SYSCLK_FREQ/eCapPwmPeriod.
 
+//
+// Rise-time measurement: CMPSS1 -> Output X-BAR -> Input X-BAR -> eCAP2/eCAP3.
+// Wire the signal under test to ADCINA2 (CMPIN1P). COMPL trips at 10% and
+// COMPH at 90% of the expected swing; the trip outputs leave on GPIO25/GPIO24
+// and come back in on eCAP2/eCAP3, whose counters are synchronized, so each
+// edge is timestamped in hardware at SYSCLK (5 ns) resolution.
+//
+#define RISE_TIME_ON        1       // 1 = configure the CMPSS/eCAP rise-time path.
+#define RISE_SWING_LOW_MV   0       // Expected low level of the edge (mV).
+#define RISE_SWING_HIGH_MV  3300    // Expected high level of the edge (mV).
+#define CMPSS_VREF_MV       3300    // DAC reference = VDDA.
+#define RISE_LEVEL(pct)     ((uint16_t)(((uint32_t)RISE_SWING_LOW_MV + \
+                             (uint32_t)(RISE_SWING_HIGH_MV - RISE_SWING_LOW_MV) * (pct) / 100U) \
+                             * 4096U / CMPSS_VREF_MV))
+#define RISE_PIN_10         25      // GPIO carrying CTRIPOUTL (Output X-BAR2).
+#define RISE_PIN_90         24      // GPIO carrying CTRIPOUTH (Output X-BAR1).
+
+uint32_t RiseTime;              // Last 10->90% rise, SYSCLK cycles (x5 ns).
+uint32_t FallTime;              // Last 90->10% fall, SYSCLK cycles.
+uint32_t RiseTimeMin = 0xFFFFFFFF;
+uint32_t RiseTimeMax = 0;
+uint32_t FallTimeMin = 0xFFFFFFFF;
+uint32_t FallTimeMax = 0;
+uint32_t RiseEdgeCtr = 0;       // Edges measured.
+uint32_t RiseMissCtr = 0;       // Pulses that never crossed 90% (or glitched).
+
+//
+// Continuous edge logging. F2837xD eCAPs cannot trigger the DMA, so ecap1ISR
+// is cut down to one interrupt per two PWM periods (CEVT4) that copies the
+// four absolute timestamps into a RAM ring. The background loop drains the
+// ring into fixed-size histograms, so memory stays bounded for any run length.
+//
+#define EDGE_LOG_ON         1       // 1 = log every eCAP1 edge and histogram it.
+#define EDGE_RING_SIZE      256     // Timestamps, power of two (64 interrupts).
+#define RISE_RING_SIZE      64      // Rise times, power of two.
+#define HIST_BINS           64
+#define HIST_BIN_CYCLES     4       // Bin width in SYSCLK cycles (20 ns).
+#define HIST_UPDATE_EDGES   1024    // Recompute percentiles every N periods.
+
+typedef struct {
+    uint32_t center;            // Value of the middle bin (first sample seen).
+    uint32_t bin[HIST_BINS];
+    uint32_t under;             // Below the first bin.
+    uint32_t over;              // Above the last bin.
+    uint32_t count;
+    int32_t  min;               // Relative to center.
+    int32_t  max;
+} EdgeHist;
+
+uint32_t EdgeRing[EDGE_RING_SIZE];      // rise, fall, rise, fall, ...
+volatile uint32_t EdgeHead = 0;         // Timestamps written by ecap1ISR.
+uint32_t EdgeTail = 0;                  // Timestamps consumed in background.
+uint32_t EdgeOverrunCtr = 0;            // Background fell a full ring behind.
+uint32_t RiseRing[RISE_RING_SIZE];
+volatile uint32_t RiseHead = 0;
+uint32_t RiseTail = 0;
+
+EdgeHist PeriodHist;            // Rise-to-rise, SYSCLK cycles.
+EdgeHist HighHist;              // Rise-to-fall (duty), SYSCLK cycles.
+EdgeHist JitterHist;            // Period minus previous period (cycle-to-cycle).
+EdgeHist RiseHist;              // 10->90% rise time from riseTimeISR.
+int32_t  PeriodPct[3];          // p50, p99, p99.9 in SYSCLK cycles.
+int32_t  HighPct[3];
+int32_t  JitterPct[3];
+int32_t  RisePct[3];
+
+//
+// Table-driven duty modulation. ePWM1 SOCB fires at TBCTR = 0 and triggers
+// DMA CH6, which copies the next table word into the CMPA shadow register
+// (loaded on the following zero). The table repeats through DMA continuous
+// mode, so the modulation costs no CPU. Each entry is held for
+// DUTY_HOLD_PERIODS PWM periods (SOCB event prescaler, 1..15).
+//
+#define DUTY_DMA_ON             1       // 1 = DMA duty profile, 0 = legacy ISR ramp.
+#define DUTY_TABLE_SIZE         512     // Entries per profile cycle.
+#define DUTY_HOLD_PERIODS       15      // 512 x 15 x 0.5 ms = 3.8 s per cycle.
+#define DUTY_STEP_LEVELS        4       // Levels in the STEPS profile.
+#define DUTY_DMA_BASE           DMA_CH6_BASE
+#define DUTY_PROFILE_TRIANGLE   0
+#define DUTY_PROFILE_SINE       1
+#define DUTY_PROFILE_STEPS      2
+
+#pragma DATA_SECTION(DutyTable, "ramgs0")   // DMA cannot reach LSx RAM.
+uint16_t DutyTable[DUTY_TABLE_SIZE];
+uint16_t DutyProfile = DUTY_PROFILE_TRIANGLE;   // Write from the debugger to switch.
+uint16_t DutyProfileActive = 0xFFFF;
+uint16_t DutyModActive = 0;
+uint32_t DutyHeld = 0xFFFFFFFF; // ePwm_curDuty last written to CMPA.
+#if !DUTY_DMA_ON
+uint16_t DutyModDir = 0;        // Flag to control duty mod direction up/down.
+uint16_t DutyModCtr = 0;        // Counter to slow down rate of modulation.
+#endif
+
 
 __interrupt void adcA1ISR(void)
 {
@@ -89,6 +181,7 @@ __interrupt void adcA1ISR(void)
     } else {
         LedCtr += 1;
     }
+#if !DUTY_DMA_ON
     if (DutyModOn) {
         // Divide 50kHz sample rate by 16 to slow down duty modulation.
         if (DutyModCtr >= 15) {
@@ -114,20 +207,335 @@ __interrupt void adcA1ISR(void)
     }
     // Set the counter compare value.
     EPWM_setCounterCompareValue(myEPWM0_BASE, EPWM_COUNTER_COMPARE_A, ePwm_curDuty);
+#endif
 }
 
 
 __interrupt void ecap1ISR(void)
 {
     Interrupt_clearACKGroup(INT_myECAP0_INTERRUPT_ACK_GROUP);
-    ECAP_clearInterrupt(myECAP0_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_3);
+    ECAP_clearInterrupt(myECAP0_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_3 |
+                                      ECAP_ISR_SOURCE_CAPTURE_EVENT_4);
     ECAP_clearGlobalInterrupt(myECAP0_BASE);
+#if EDGE_LOG_ON
+    // CEVT4: CAP1..CAP4 hold rise, fall, rise, fall of the last two periods.
+    EdgeRing[(EdgeHead + 0) & (EDGE_RING_SIZE - 1)] = ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_1);
+    EdgeRing[(EdgeHead + 1) & (EDGE_RING_SIZE - 1)] = ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_2);
+    EdgeRing[(EdgeHead + 2) & (EDGE_RING_SIZE - 1)] = ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_3);
+    EdgeRing[(EdgeHead + 3) & (EDGE_RING_SIZE - 1)] = ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_4);
+    EdgeHead += 4;
+#endif
     eCapPwmDuty = (int32_t)ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_2) -
                   (int32_t)ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_1);
     eCapPwmPeriod = (int32_t)ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_3) -
                     (int32_t)ECAP_getEventTimeStamp(myECAP0_BASE, ECAP_EVENT_1);
 }
 
+__interrupt void riseTimeISR(void)
+{
+    // eCAP2 CEVT2 = 10% falling crossing, the last of the four edges.
+    uint32_t t10r = ECAP_getEventTimeStamp(ECAP2_BASE, ECAP_EVENT_1);
+    uint32_t t10f = ECAP_getEventTimeStamp(ECAP2_BASE, ECAP_EVENT_2);
+    uint32_t t90r = ECAP_getEventTimeStamp(ECAP3_BASE, ECAP_EVENT_1);
+    uint32_t t90f = ECAP_getEventTimeStamp(ECAP3_BASE, ECAP_EVENT_2);
+
+    // Both counters run from the same sync, so plain differences are valid
+    // across the 32-bit wrap. 90% crossings must fall inside the 10% pulse.
+    if ((t90r - t10r) < (t10f - t10r) && (t90f - t10r) < (t10f - t10r)) {
+        RiseTime = t90r - t10r;
+        FallTime = t10f - t90f;
+        if (RiseTime < RiseTimeMin) RiseTimeMin = RiseTime;
+        if (RiseTime > RiseTimeMax) RiseTimeMax = RiseTime;
+        if (FallTime < FallTimeMin) FallTimeMin = FallTime;
+        if (FallTime > FallTimeMax) FallTimeMax = FallTime;
+        RiseEdgeCtr += 1;
+#if EDGE_LOG_ON
+        RiseRing[RiseHead & (RISE_RING_SIZE - 1)] = RiseTime;
+        RiseHead += 1;
+#endif
+    } else {
+        RiseMissCtr += 1;
+    }
+
+    ECAP_clearInterrupt(ECAP2_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_2);
+    ECAP_clearGlobalInterrupt(ECAP2_BASE);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP4);
+}
+
+//
+// Capture rising edge on CEVT1, falling edge on CEVT2, absolute timestamps.
+//
+static void initRiseTimeECAP(uint32_t base, XBAR_InputNum input, uint16_t pin)
+{
+    XBAR_setInputPin(input, pin);
+
+    ECAP_disableInterrupt(base, ECAP_ISR_SOURCE_CAPTURE_EVENT_1 |
+                                ECAP_ISR_SOURCE_CAPTURE_EVENT_2 |
+                                ECAP_ISR_SOURCE_CAPTURE_EVENT_3 |
+                                ECAP_ISR_SOURCE_CAPTURE_EVENT_4 |
+                                ECAP_ISR_SOURCE_COUNTER_OVERFLOW |
+                                ECAP_ISR_SOURCE_COUNTER_PERIOD |
+                                ECAP_ISR_SOURCE_COUNTER_COMPARE);
+    ECAP_clearInterrupt(base, ECAP_ISR_SOURCE_CAPTURE_EVENT_1 |
+                              ECAP_ISR_SOURCE_CAPTURE_EVENT_2);
+    ECAP_disableTimeStampCapture(base);
+    ECAP_stopCounter(base);
+    ECAP_enableCaptureMode(base);
+    ECAP_setCaptureMode(base, ECAP_CONTINUOUS_CAPTURE_MODE, ECAP_EVENT_2);
+    ECAP_setEventPolarity(base, ECAP_EVENT_1, ECAP_EVNT_RISING_EDGE);
+    ECAP_setEventPolarity(base, ECAP_EVENT_2, ECAP_EVNT_FALLING_EDGE);
+    ECAP_disableCounterResetOnEvent(base, ECAP_EVENT_1);
+    ECAP_disableCounterResetOnEvent(base, ECAP_EVENT_2);
+    ECAP_setEventPrescaler(base, 0);
+    ECAP_setPhaseShiftCount(base, 0);
+    ECAP_enableLoadCounter(base);
+    ECAP_setSyncOutMode(base, ECAP_SYNC_OUT_SYNCI);
+    ECAP_enableTimeStampCapture(base);
+    ECAP_startCounter(base);
+    ECAP_reArm(base);
+}
+
+void initRiseTime(void)
+{
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_CMPSS1);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_ECAP2);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_ECAP3);
+
+    // CMPSS1: COMPH vs DACH (90%), COMPL vs DACL (10%). COMPL trips when the
+    // input is below DACL, so invert it to get a rising edge on the way up.
+    CMPSS_enableModule(CMPSS1_BASE);
+    CMPSS_configDAC(CMPSS1_BASE, CMPSS_DACREF_VDDA | CMPSS_DACVAL_SYSCLK |
+                                 CMPSS_DACSRC_SHDW);
+    CMPSS_setDACValueHigh(CMPSS1_BASE, RISE_LEVEL(90));
+    CMPSS_setDACValueLow(CMPSS1_BASE, RISE_LEVEL(10));
+    CMPSS_configHighComparator(CMPSS1_BASE, CMPSS_INSRC_DAC);
+    CMPSS_configLowComparator(CMPSS1_BASE, CMPSS_INSRC_DAC | CMPSS_INV_INVERTED);
+    CMPSS_setHysteresis(CMPSS1_BASE, 1);
+    // Asynchronous outputs - both paths see the same comparator delay, so it
+    // cancels in the 10->90 difference.
+    CMPSS_configOutputsHigh(CMPSS1_BASE, CMPSS_TRIPOUT_ASYNC_COMP | CMPSS_TRIP_ASYNC_COMP);
+    CMPSS_configOutputsLow(CMPSS1_BASE, CMPSS_TRIPOUT_ASYNC_COMP | CMPSS_TRIP_ASYNC_COMP);
+    DEVICE_DELAY_US(100);
+
+    // CTRIPOUTH -> Output X-BAR1 -> GPIO24, CTRIPOUTL -> Output X-BAR2 -> GPIO25.
+    XBAR_setOutputMuxConfig(XBAR_OUTPUT1, XBAR_OUT_MUX00_CMPSS1_CTRIPOUTH);
+    XBAR_enableOutputMux(XBAR_OUTPUT1, XBAR_MUX00);
+    XBAR_setOutputMuxConfig(XBAR_OUTPUT2, XBAR_OUT_MUX01_CMPSS1_CTRIPOUTL);
+    XBAR_enableOutputMux(XBAR_OUTPUT2, XBAR_MUX01);
+    GPIO_setPinConfig(GPIO_24_OUTPUTXBAR1);
+    GPIO_setPinConfig(GPIO_25_OUTPUTXBAR2);
+    // Async qualification - the input sync stage would add 1 SYSCLK of jitter.
+    GPIO_setQualificationMode(RISE_PIN_90, GPIO_QUAL_ASYNC);
+    GPIO_setQualificationMode(RISE_PIN_10, GPIO_QUAL_ASYNC);
+
+    // Read the pins back: INPUT8 feeds eCAP2, INPUT9 feeds eCAP3.
+    initRiseTimeECAP(ECAP2_BASE, XBAR_INPUT8, RISE_PIN_10);
+    initRiseTimeECAP(ECAP3_BASE, XBAR_INPUT9, RISE_PIN_90);
+
+    // Software sync on eCAP2 loads both counters (eCAP3 SYNCI = eCAP2 SYNCO),
+    // then stop listening so later syncs from the chain cannot split them.
+    ECAP_loadCounter(ECAP2_BASE);
+    ECAP_disableLoadCounter(ECAP2_BASE);
+    ECAP_disableLoadCounter(ECAP3_BASE);
+
+    Interrupt_register(INT_ECAP2, &riseTimeISR);
+    ECAP_enableInterrupt(ECAP2_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_2);
+    Interrupt_enable(INT_ECAP2);
+}
+
+//
+// Streaming histograms
+//
+static void histAdd(EdgeHist *h, uint32_t v)
+{
+    int32_t rel;
+    int32_t idx;
+
+    if (h->count == 0) {
+        h->center = v;
+        h->min = 0;
+        h->max = 0;
+    }
+    // Signed offset from the first sample, so a histogram of differences
+    // (JitterHist) works with the same code.
+    rel = (int32_t)(v - h->center);
+    if (rel < h->min) h->min = rel;
+    if (rel > h->max) h->max = rel;
+    idx = rel / HIST_BIN_CYCLES + HIST_BINS / 2;
+    if (idx < 0) {
+        h->under += 1;
+    } else if (idx >= HIST_BINS) {
+        h->over += 1;
+    } else {
+        h->bin[idx] += 1;
+    }
+    h->count += 1;
+}
+
+//
+// Value below which permille/1000 of the samples fall, at bin resolution.
+// Samples outside the bins are reported as the observed min/max.
+//
+static int32_t histPercentile(const EdgeHist *h, uint16_t permille)
+{
+    uint32_t target = (uint32_t)(((uint64_t)h->count * permille + 999) / 1000);
+    uint32_t acc = h->under;
+    uint16_t i;
+
+    if (h->count == 0) return 0;
+    if (acc >= target) return (int32_t)h->center + h->min;
+    for (i = 0; i < HIST_BINS; i++) {
+        acc += h->bin[i];
+        if (acc >= target) {
+            return (int32_t)h->center +
+                   ((int32_t)i - HIST_BINS / 2) * HIST_BIN_CYCLES + HIST_BIN_CYCLES / 2;
+        }
+    }
+    return (int32_t)h->center + h->max;
+}
+
+static void histPercentiles(const EdgeHist *h, int32_t *pct)
+{
+    pct[0] = histPercentile(h, 500);
+    pct[1] = histPercentile(h, 990);
+    pct[2] = histPercentile(h, 999);
+}
+
+//
+// Drain the timestamp rings into the histograms. Runs in the background loop.
+//
+void processEdgeLog(void)
+{
+    static uint32_t lastRise;
+    static uint32_t lastPeriod;
+    static uint16_t havePrev = 0;       // 1 = lastRise valid, 2 = lastPeriod too.
+    static uint32_t sinceUpdate = 0;
+    uint32_t head = EdgeHead;
+    uint32_t rise, fall, period;
+
+    if (head - EdgeTail > EDGE_RING_SIZE) {
+        // Lost a stretch of edges - restart the period chain after the gap.
+        EdgeOverrunCtr += 1;
+        EdgeTail = head;
+        havePrev = 0;
+    }
+    while (head - EdgeTail >= 2) {
+        rise = EdgeRing[EdgeTail & (EDGE_RING_SIZE - 1)];
+        fall = EdgeRing[(EdgeTail + 1) & (EDGE_RING_SIZE - 1)];
+        EdgeTail += 2;
+
+        histAdd(&HighHist, fall - rise);
+        if (havePrev) {
+            period = rise - lastRise;
+            histAdd(&PeriodHist, period);
+            if (havePrev > 1) histAdd(&JitterHist, period - lastPeriod);
+            lastPeriod = period;
+            havePrev = 2;
+        } else {
+            havePrev = 1;
+        }
+        lastRise = rise;
+        sinceUpdate += 1;
+    }
+
+    head = RiseHead;
+    if (head - RiseTail > RISE_RING_SIZE) RiseTail = head - RISE_RING_SIZE;
+    while (RiseTail != head) {
+        histAdd(&RiseHist, RiseRing[RiseTail & (RISE_RING_SIZE - 1)]);
+        RiseTail += 1;
+    }
+
+    if (sinceUpdate >= HIST_UPDATE_EDGES) {
+        histPercentiles(&PeriodHist, PeriodPct);
+        histPercentiles(&HighHist, HighPct);
+        histPercentiles(&JitterHist, JitterPct);
+        histPercentiles(&RiseHist, RisePct);
+        sinceUpdate = 0;
+    }
+}
+
+//
+// Fill DutyTable with one cycle of the selected profile between the
+// ePwm_MinDuty and ePwm_MaxDuty compare values.
+//
+void buildDutyTable(uint16_t profile)
+{
+    uint32_t lo = (ePwm_MinDuty < ePwm_MaxDuty) ? ePwm_MinDuty : ePwm_MaxDuty;
+    uint32_t span = ((ePwm_MinDuty < ePwm_MaxDuty) ? ePwm_MaxDuty : ePwm_MinDuty) - lo;
+    uint16_t k;
+    uint32_t pos;
+
+    for (k = 0; k < DUTY_TABLE_SIZE; k++) {
+        if (profile == DUTY_PROFILE_SINE) {
+            float w = 0.5f - 0.5f * cosf(6.2831853f * (float)k / (float)DUTY_TABLE_SIZE);
+            pos = (uint32_t)(w * (float)span + 0.5f);
+        } else if (profile == DUTY_PROFILE_STEPS) {
+            pos = span * (k / (DUTY_TABLE_SIZE / DUTY_STEP_LEVELS)) / (DUTY_STEP_LEVELS - 1);
+        } else {
+            // Triangle: up over the first half, back down over the second.
+            pos = (k < DUTY_TABLE_SIZE / 2) ? k : (DUTY_TABLE_SIZE - k);
+            pos = span * pos / (DUTY_TABLE_SIZE / 2);
+        }
+        DutyTable[k] = (uint16_t)(lo + pos);
+    }
+}
+
+//
+// ePWM1 SOCB (TBCTR = 0) -> DMA CH6 -> CMPA shadow, one word per event.
+//
+void initDutyDMA(void)
+{
+    // The DMA needs to own peripheral frame 1 (ePWM) as secondary master;
+    // frame 2 stays with the CLA, its reset default.
+    SysCtl_selectSecMaster(SYSCTL_SEC_MASTER_DMA, SYSCTL_SEC_MASTER_CLA);
+
+    DMA_initController();
+    DMA_setEmulationMode(DMA_EMULATION_FREE_RUN);
+    // CMPA is the upper word of the 32-bit CMPA:CMPAHR pair.
+    DMA_configAddresses(DUTY_DMA_BASE,
+                        (uint16_t *)(myEPWM0_BASE + EPWM_O_CMPA + 1U), DutyTable);
+    DMA_configBurst(DUTY_DMA_BASE, 1, 0, 0);
+    DMA_configTransfer(DUTY_DMA_BASE, DUTY_TABLE_SIZE, 1, 0);
+    DMA_configMode(DUTY_DMA_BASE, DMA_TRIGGER_EPWM1SOCB, DMA_CFG_ONESHOT_DISABLE |
+                   DMA_CFG_CONTINUOUS_ENABLE | DMA_CFG_SIZE_16BIT);
+    DMA_enableTrigger(DUTY_DMA_BASE);
+
+    EPWM_setADCTriggerSource(myEPWM0_BASE, EPWM_SOC_B, EPWM_SOC_TBCTR_ZERO);
+    EPWM_setADCTriggerEventPrescale(myEPWM0_BASE, EPWM_SOC_B, DUTY_HOLD_PERIODS);
+    EPWM_enableADCTrigger(myEPWM0_BASE, EPWM_SOC_B);
+}
+
+//
+// Follow DutyModOn / DutyProfile from the background loop: rebuild the
+// table only while the channel is stopped, restart it from entry 0. With
+// modulation off, ePwm_curDuty edits reach CMPA as they did from the ISR.
+//
+void updateDutyModulation(void)
+{
+    if (DutyModOn && (!DutyModActive || DutyProfile != DutyProfileActive)) {
+        DMA_stopChannel(DUTY_DMA_BASE);
+        buildDutyTable(DutyProfile);
+        DMA_configAddresses(DUTY_DMA_BASE,
+                            (uint16_t *)(myEPWM0_BASE + EPWM_O_CMPA + 1U), DutyTable);
+        // A stop only pauses the channel; the soft reset drops its active
+        // address and counters so the start reloads from entry 0.
+        DMA_triggerSoftReset(DUTY_DMA_BASE);
+        DMA_startChannel(DUTY_DMA_BASE);
+        DutyProfileActive = DutyProfile;
+        DutyModActive = 1;
+    } else if (!DutyModOn) {
+        if (DutyModActive) {
+            DMA_stopChannel(DUTY_DMA_BASE);
+            DutyModActive = 0;
+            DutyHeld = 0xFFFFFFFF;  // The DMA overwrote CMPA; always restore it.
+        }
+        if (ePwm_curDuty != DutyHeld) {
+            EPWM_setCounterCompareValue(myEPWM0_BASE, EPWM_COUNTER_COMPARE_A, ePwm_curDuty);
+            DutyHeld = ePwm_curDuty;
+        }
+    }
+}
+
 //
 // Main
 //
@@ -149,11 +557,36 @@ void main(void)
 
     // DutyModOn = 1;
 
+#if DUTY_DMA_ON
+    initDutyDMA();
+#endif
+
+#if RISE_TIME_ON
+    initRiseTime();
+#endif
+
+#if EDGE_LOG_ON
+    // Absolute timestamps, one interrupt per four captured edges.
+    ECAP_disableCounterResetOnEvent(myECAP0_BASE, ECAP_EVENT_1);
+    ECAP_disableCounterResetOnEvent(myECAP0_BASE, ECAP_EVENT_2);
+    ECAP_disableCounterResetOnEvent(myECAP0_BASE, ECAP_EVENT_3);
+    ECAP_disableCounterResetOnEvent(myECAP0_BASE, ECAP_EVENT_4);
+    ECAP_disableInterrupt(myECAP0_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_3);
+    ECAP_enableInterrupt(myECAP0_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_4);
+#endif
+
     EINT;
     ERTM;
 
     for (;;) {
+#if DUTY_DMA_ON
+        updateDutyModulation();
+#endif
+#if EDGE_LOG_ON
+        processEdgeLog();
+#else
         NOP;
+#endif
     }
 }
 